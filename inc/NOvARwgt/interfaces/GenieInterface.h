@@ -9,7 +9,9 @@
 #ifndef NOVARWGT_GENIEINTERFACE_H
 #define NOVARWGT_GENIEINTERFACE_H
 
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "NOvARwgt/rwgt/EventRecord.h"
 
@@ -21,8 +23,62 @@ namespace genie
 
 namespace novarwgt
 {
+	/// \brief Converts GENIE records into novarwgt::EventRecords.
+	///
+	/// The generator context (GENIE version and tune) is looked up once, when the converter is constructed,
+	/// rather than for every event.  (For GENIE 3, this means the tune must already be set
+	/// in genie::XSecSplineList by then.)
+	///
+	/// The Convert() overloads that take an output record overwrite it in place, reusing its storage,
+	/// so converting many events into the same record(s) doesn't allocate per event.
+	/// A converter has no mutable state, so one instance can be shared between threads.
+	class GenieEventConverter
+	{
+		public:
+			GenieEventConverter();
+
+			/// Convert \a evt into \a rec, overwriting everything in it.  No stored weights.
+			void Convert(const genie::EventRecord * evt, novarwgt::EventRecord & rec) const;
+
+			/// Convert \a evt into \a rec, overwriting everything in it, and copy in the stored weights \a storedWgts.
+			void Convert(const genie::EventRecord * evt,
+			             novarwgt::EventRecord & rec,
+			             const novarwgt::ReweightList & storedWgts) const;
+
+			/// Convert \a evt into a new record
+			novarwgt::EventRecord Convert(const genie::EventRecord * evt) const;
+
+			/// Convert \a evt into a new record, with stored weights \a storedWgts
+			novarwgt::EventRecord Convert(const genie::EventRecord * evt,
+			                              const novarwgt::ReweightList & storedWgts) const;
+
+			/// Convert a whole set of GENIE records.
+			/// \a out is resized to match \a evts, and the records already in it are reused,
+			/// so passing the same vector for each batch acts as a record pool.
+			void Convert(const std::vector<const genie::EventRecord*> & evts,
+			             std::vector<novarwgt::EventRecord> & out) const;
+
+			/// As above, but also copy in stored weights (\a storedWgts must be the same length as \a evts)
+			void Convert(const std::vector<const genie::EventRecord*> & evts,
+			             const std::vector<novarwgt::ReweightList> & storedWgts,
+			             std::vector<novarwgt::EventRecord> & out) const;
+
+			const std::vector<int> & GeneratorVersion() const { return fGeneratorVersion; }
+			const std::string &      GeneratorConfig()  const { return fGeneratorConfig; }
+
+		private:
+			/// Everything except the stored weights
+			void FillRecord(const genie::EventRecord * evt, novarwgt::EventRecord & rec) const;
+
+			std::vector<int> fGeneratorVersion;
+			std::string fGeneratorConfig;
+	};
+
 	/// Copy information out of the GENIE record.
 	///
+	/// (Looks up the GENIE configuration anew for every call;
+	///  when converting many events, a GenieEventConverter is more efficient.)
+	///
 	/// \param evt  GENIE record
 	/// \return weight for this event
 	///
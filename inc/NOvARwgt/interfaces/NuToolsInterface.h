@@ -9,16 +9,71 @@
 #ifndef NOVARWGT_NUTOOLSINTERFACE_H
 #define NOVARWGT_NUTOOLSINTERFACE_H
 
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "NOvARwgt/rwgt/EventRecord.h"
 
 namespace simb
 {
 	class MCTruth;
 	class GTruth;
+	struct MCGeneratorInfo;
 }
 
 namespace novarwgt
 {
+	/// \brief Converts NuTools (simb::MCTruth + simb::GTruth) events into novarwgt::EventRecords.
+	///
+	/// The decoded generator version & configuration are cached inside the converter.
+	/// They're only decoded again when the generator info actually changes,
+	/// which is detected by comparing it against a copy of the last one seen.
+	/// Unknown generator configuration keys are reported only once per converter.
+	///
+	/// The converter keeps per-instance state, so use one instance per thread.
+	class NuToolsEventConverter
+	{
+		public:
+			/// Convert into \a rec, overwriting everything in it (reusing its storage).
+			void Convert(const simb::MCTruth * mctruth,
+			             const simb::GTruth * gtruth,
+			             const novarwgt::ReweightList & rwList,
+			             novarwgt::EventRecord & rec);
+
+			/// Convert into a new record.
+			novarwgt::EventRecord Convert(const simb::MCTruth * mctruth,
+			                              const simb::GTruth * gtruth,
+			                              const novarwgt::ReweightList & rwList);
+
+			/// Convert a whole set of events (e.g., a spill's worth of art products) in one call.
+			/// \a out is resized to match, and the records already in it are reused.
+			/// \a rwLists may be empty (no stored weights); otherwise it must be the same length as \a mctruths.
+			void Convert(const std::vector<simb::MCTruth> & mctruths,
+			             const std::vector<simb::GTruth> & gtruths,
+			             const std::vector<novarwgt::ReweightList> & rwLists,
+			             std::vector<novarwgt::EventRecord> & out);
+
+		private:
+			/// Re-decode the generator info if it's different from what we saw last time
+			void UpdateGeneratorContext(const simb::MCGeneratorInfo & genInfo);
+
+			bool fHaveContext = false;
+			int fGenInfoGenerator = 0;
+			std::string fGenInfoVersion;
+			std::unordered_map<std::string, std::string> fGenInfoConfig;
+
+			novarwgt::Generator fGenerator = kUnknownGenerator;
+			std::vector<int> fGeneratorVersion;
+			std::string fGeneratorConfigStr;
+
+			std::unordered_set<std::string> fWarnedConfigKeys;
+	};
+
+	/// Convert a single event.
+	/// (Uses a thread-local NuToolsEventConverter internally.)
 	novarwgt::EventRecord ConvertNuToolsEvent(const simb::MCTruth * mctruth, const simb::GTruth * gtruth, const novarwgt::ReweightList & rwList);
 }
 
@@ -0,0 +1,145 @@
+/*
+ * RDataFrameInterface.h:
+ *  Interface for computing tune weights as ROOT::RDataFrame columns.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_RDATAFRAMEINTERFACE_H
+#define NOVARWGT_RDATAFRAMEINTERFACE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "NOvARwgt/interfaces/TTreeInterface.h"
+#include "NOvARwgt/rwgt/EventRecord.h"
+#include "NOvARwgt/rwgt/Tune.h"
+#include "NOvARwgt/util/InputVals.h"
+
+namespace novarwgt
+{
+	/// \brief Functor computing a Tune's CV weight from flat columns, for use with RDataFrame::DefineSlot().
+	///
+	/// Usage:
+	/// \code
+	///   ROOT::EnableImplicitMT();
+	///   ROOT::RDataFrame df("tree", "file.root");
+	///   novarwgt::TuneWeightFunctor<float, int, ROOT::RVec<float>> fn(novarwgt::kCVTune2018, df.GetNSlots(),
+	///                                                                 novarwgt::kGENIE, {2, 12, 10});
+	///   auto df2 = df.DefineSlot("wgt", fn, fn.ColumnNames());
+	/// \endcode
+	///
+	/// The column types (RealT for kinematics, IntT for the rest) must match those in the tree exactly,
+	/// as RDataFrame requires.  If a type for the stored GENIE weights is supplied as the third template argument
+	/// (usually ROOT::RVec<float>), the functor takes one extra column with the flattened weight table
+	/// (4 values per novarwgt::ReweightKnob in enum order; all-NaN entries mean 'not stored'),
+	/// just like TTreeBatchReader.
+	///
+	/// Each slot gets its own EventRecord, which is refilled in place for every entry,
+	/// so no slot ever touches another's scratch space and nothing is allocated per entry.
+	/// The weighters themselves are safe to call concurrently.
+	template <typename RealT = float, typename IntT = int, typename ... WgtsT>
+	class TuneWeightFunctor
+	{
+		static_assert(sizeof...(WgtsT) <= 1, "TuneWeightFunctor: at most one stored-weights column type can be given");
+
+		public:
+			/// \param tune        The tune whose CV weight is desired
+			/// \param nSlots      Number of RDataFrame processing slots
+			/// \param gen         Generator the events were made with
+			/// \param genVersion  Generator version, as in EventRecord::generatorVersion
+			/// \param genConfig   Generator configuration, as in EventRecord::generatorConfigStr
+			/// \param params      Any other parameters to pass to the tune
+			TuneWeightFunctor(const novarwgt::Tune & tune,
+			                  unsigned int nSlots,
+			                  novarwgt::Generator gen,
+			                  const std::vector<int> & genVersion,
+			                  const std::string & genConfig = "",
+			                  novarwgt::InputVals params = {})
+				: fTune(&tune), fParams(std::move(params)), fRecords(nSlots)
+			{
+				if (nSlots == 0)
+					throw std::runtime_error("NOvARwgt: TuneWeightFunctor needs at least one slot");
+
+				// generator info is the same for every entry, so set it just once per slot
+				for (auto & rec : fRecords)
+				{
+					rec.generator = gen;
+					rec.generatorVersion = genVersion;
+					rec.generatorConfigStr = genConfig;
+				}
+			}
+
+			/// Names of the columns to pass to DefineSlot(), in the order operator() expects them.
+			/// Uses the same naming scheme as TTreeBatchReader.
+			static std::vector<std::string> ColumnNames(const novarwgt::TTreeBranchNames & names = {})
+			{
+				std::vector<std::string> cols { names.Enu, names.q0, names.q3, names.y, names.W,
+				                                names.mode, names.ccnc, names.pdg, names.tgtA, names.hitnuc,
+				                                names.npiplus, names.npizero, names.npiminus };
+				if (sizeof...(WgtsT) > 0)
+					cols.push_back(names.genieWgts);
+				return cols;
+			}
+
+			double operator()(unsigned int slot,
+			                  RealT Enu, RealT q0, RealT q3, RealT y, RealT W,
+			                  IntT mode, IntT ccnc, IntT pdg, IntT tgtA, IntT hitnuc,
+			                  IntT npiplus, IntT npizero, IntT npiminus,
+			                  const WgtsT & ... genieWgts)
+			{
+				novarwgt::EventRecord & rec = fRecords[slot];
+
+				rec.nupdg = pdg;
+				rec.isCC = (ccnc == 0);
+				rec.reaction = novarwgt::ReactionType(mode);
+				rec.struckNucl = hitnuc;
+
+				rec.Enu = Enu;
+				// the direction of q isn't stored, so just put it along z
+				rec.q.SetPxPyPzE(0, 0, q3, q0);
+				rec.y = y;
+				rec.W = W;
+
+				rec.A = tgtA;
+
+				rec.npiplus = npiplus;
+				rec.npizero = npizero;
+				rec.npiminus = npiminus;
+
+				rec.genieWeights.clear();
+				int dummy[] = {0, (FillStoredWgts(rec, genieWgts), 0)...};
+				(void) dummy;
+				rec.Finalize();
+
+				return fTune->EventWeight(rec, fParams);
+			}
+
+		private:
+			template <typename Wgts>
+			static void FillStoredWgts(novarwgt::EventRecord & rec, const Wgts & wgts)
+			{
+				std::size_t nKnobs = std::min(std::size_t(wgts.size() / 4), std::size_t(novarwgt::kLastKnob));
+				rec.genieWeights.resize(nKnobs);  // everything starts out 'not set'
+				for (std::size_t knobIdx = 0; knobIdx < nKnobs; knobIdx++)
+				{
+					const std::size_t offset = 4 * knobIdx;
+					if (std::isnan(wgts[offset]) && std::isnan(wgts[offset+1]) && std::isnan(wgts[offset+2]) && std::isnan(wgts[offset+3]))
+						continue;
+					rec.genieWeights[knobIdx] = {float(wgts[offset]), float(wgts[offset+1]), float(wgts[offset+2]), float(wgts[offset+3])};
+				}
+			}
+
+			const novarwgt::Tune * fTune;
+			novarwgt::InputVals fParams;
+			std::vector<novarwgt::EventRecord> fRecords;   ///< one per slot
+	};
+
+}
+
+#endif //NOVARWGT_RDATAFRAMEINTERFACE_H
@@ -0,0 +1,115 @@
+/*
+ * TTreeInterface.h:
+ *  Interface to flat ROOT ntuples of truth information.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_TTREEINTERFACE_H
+#define NOVARWGT_TTREEINTERFACE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Rtypes.h"
+
+#include "NOvARwgt/rwgt/EventRecord.h"
+
+class TBranch;
+class TBufferFile;
+class TTree;
+
+namespace novarwgt
+{
+	struct EventBatch;
+
+	/// Names of the branches read by TTreeBatchReader.
+	/// Set any of them to the empty string if the tree doesn't have that branch.
+	///
+	/// Each branch must hold one number per entry (of any of the usual fundamental types),
+	/// except for the GENIE weights, which should be a fixed-length array
+	/// of 4 values (-2, -1, +1, +2 sigma) per novarwgt::ReweightKnob, in enum order.
+	/// Knobs whose four values are all NaN are treated as not stored.
+	struct TTreeBranchNames
+	{
+		std::string Enu      = "Enu";
+		std::string Q2       = "Q2";       ///< only used if q3 is not available.  Entries with Q2 < -q0^2 are an error
+		std::string q0       = "q0";       ///< if not available, computed as y * Enu
+		std::string q3       = "q3";
+		std::string W        = "W";
+		std::string y        = "y";        ///< if not available, computed as q0 / Enu
+		std::string mode     = "mode";     ///< GENIE scattering type (novarwgt::ReactionType)
+		std::string ccnc     = "ccnc";     ///< 0 = CC, 1 = NC (simb::curr_type_ convention)
+		std::string pdg      = "pdg";      ///< neutrino PDG code
+		std::string tgtA     = "tgtA";
+		std::string hitnuc   = "hitnuc";   ///< PDG code of struck nucleon
+		std::string npiplus  = "npiplus";
+		std::string npizero  = "npizero";
+		std::string npiminus = "npiminus";
+		std::string genieWgts = "genieWgts";
+	};
+
+	/// Reads flat truth ntuples column-by-column into a novarwgt::EventBatch.
+	///
+	/// Where ROOT supports it (ROOT >= 6.16, simple branches of fundamental type),
+	/// whole baskets are read at a time using the bulk I/O interface
+	/// and unpacked straight into the batch's columns.
+	/// Other branches fall back to ordinary per-entry reads of that branch only.
+	class TTreeBatchReader
+	{
+		public:
+			explicit TTreeBatchReader(TTree * tree, TTreeBranchNames branchNames = {});
+			~TTreeBatchReader();
+
+			/// Generator info to be stamped onto every batch.  (Not usually stored in flat trees.)
+			void SetGeneratorInfo(novarwgt::Generator gen, std::vector<int> version, std::string configStr = "");
+
+			/// Total number of entries in the tree
+			Long64_t GetEntries() const;
+
+			/// Read up to \a nEntries entries starting at \a firstEntry into \a batch.
+			/// The batch is resized as needed, but its storage is reused when possible.
+			/// \return  number of entries actually read
+			/// Throws std::runtime_error if |q| has to be computed from Q2 for an entry where it can't be (Q2 < -q0^2).
+			std::size_t ReadBatch(Long64_t firstEntry, std::size_t nEntries, novarwgt::EventBatch & batch);
+
+		private:
+			TBranch * FindBranch(const std::string & name) const;
+
+			/// Read \a n entries of a single-valued branch starting at \a first, converting to T
+			template <typename T>
+			void ReadColumn(TBranch * branch, Long64_t first, std::size_t n, T * out);
+
+			void ReadWeights(Long64_t first, std::size_t n, novarwgt::EventBatch & batch);
+
+			TTree * fTree;
+
+			TBranch * fEnuBranch;
+			TBranch * fQ2Branch;
+			TBranch * fq0Branch;
+			TBranch * fq3Branch;
+			TBranch * fWBranch;
+			TBranch * fyBranch;
+			TBranch * fModeBranch;
+			TBranch * fCCNCBranch;
+			TBranch * fPdgBranch;
+			TBranch * fTgtABranch;
+			TBranch * fHitNucBranch;
+			TBranch * fNPiPlusBranch;
+			TBranch * fNPiZeroBranch;
+			TBranch * fNPiMinusBranch;
+			TBranch * fWgtsBranch;
+
+			novarwgt::Generator fGenerator;
+			std::vector<int> fGeneratorVersion;
+			std::string fGeneratorConfigStr;
+
+			std::unique_ptr<TBufferFile> fBuffer;     ///< scratch for the bulk reads
+			std::vector<double> fScratch;             ///< scratch for derived columns
+	};
+
+}
+
+#endif //NOVARWGT_TTREEINTERFACE_H
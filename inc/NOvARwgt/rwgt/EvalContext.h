@@ -0,0 +1,125 @@
+/*
+ * EvalContext.h:
+ *  Per-event memo of weighter results, so nested weighters only run once per event.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_EVALCONTEXT_H
+#define NOVARWGT_EVALCONTEXT_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "NOvARwgt/rwgt/EventRecord.h"
+
+namespace novarwgt
+{
+	// forward declarations
+	class InputVals;
+	class IWeightGenerator;
+
+	/// \brief Weights already computed for one event, keyed by the weighter that computed them.
+	///
+	/// Weighters are frequently evaluated more than once per event:
+	/// the CV of a tune, the CV weights that syst knobs are computed relative to (ISystKnob::CVWgt()),
+	/// and knobs or weighters that dispatch to other weighters all call GetWeight() on the same objects.
+	/// While a context is active on a thread (see EvalContextScope), IWeightGenerator::GetWeight()
+	/// remembers each weighter's result in it, so each one is only computed once for the event.
+	///
+	/// A context is bound to one event record (by address and EventRecord::Serial())
+	/// and one set of parameters (by address); calls for any other event or parameters simply bypass it.
+	/// A record refilled in place through Finalize() (as the converters, EventBatch::FillRecord() and
+	/// TuneWeightFunctor do) gets a new serial, so it doesn't match the context made for its previous contents.
+	/// If you modify a record by hand while a context for it is active, call Finalize() afterwards.
+	class EvalContext
+	{
+		public:
+			/// Forget everything and bind to a new event (the storage is kept)
+			void Reset(const novarwgt::EventRecord & ev, const novarwgt::InputVals & params)
+			{
+				fEvt = &ev;
+				fEvtSerial = ev.Serial();
+				fParams = &params;
+				fWgts.clear();
+			}
+
+			/// Is this context the one for \a ev and \a params?
+			bool Matches(const novarwgt::EventRecord & ev, const novarwgt::InputVals & params) const
+			{
+				return fEvt == &ev && fEvtSerial == ev.Serial() && fParams == &params;
+			}
+
+			/// Look up the stored weight for \a wgtr.  Returns false if it hasn't been computed yet.
+			bool Find(const novarwgt::IWeightGenerator * wgtr, double & wgt) const
+			{
+				// only a handful of weighters per event, so a linear search beats hashing
+				for (const auto & entry : fWgts)
+				{
+					if (entry.first == wgtr)
+					{
+						wgt = entry.second;
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void Store(const novarwgt::IWeightGenerator * wgtr, double wgt)
+			{
+				fWgts.emplace_back(wgtr, wgt);
+			}
+
+			/// The context in use on this thread, or nullptr if none
+			static EvalContext * Active() { return ActiveRef(); }
+
+		private:
+			friend class EvalContextScope;
+
+			static EvalContext *& ActiveRef()
+			{
+				static thread_local EvalContext * ctx = nullptr;
+				return ctx;
+			}
+
+			const novarwgt::EventRecord * fEvt = nullptr;
+			std::uint64_t fEvtSerial = 0;
+			const novarwgt::InputVals * fParams = nullptr;
+			std::vector<std::pair<const novarwgt::IWeightGenerator*, double>> fWgts;
+	};
+
+	/// Activates an EvalContext on this thread for as long as it lives.
+	///
+	/// If a context for the same event and parameters is already active (e.g., a Tune method called
+	/// from inside another one, or from user code that set up its own scope so that the CV and all
+	/// the knobs share one context), that context keeps being used and \a ctx is left alone.
+	/// Otherwise \a ctx is reset for \a ev and made the active one until the scope ends.
+	class EvalContextScope
+	{
+		public:
+			EvalContextScope(EvalContext & ctx, const novarwgt::EventRecord & ev, const novarwgt::InputVals & params)
+				: fPrevious(EvalContext::ActiveRef())
+			{
+				if (fPrevious && fPrevious->Matches(ev, params))
+					return;
+
+				ctx.Reset(ev, params);
+				EvalContext::ActiveRef() = &ctx;
+			}
+
+			~EvalContextScope()
+			{
+				EvalContext::ActiveRef() = fPrevious;
+			}
+
+			EvalContextScope(const EvalContextScope &) = delete;
+			EvalContextScope & operator=(const EvalContextScope &) = delete;
+
+		private:
+			EvalContext * fPrevious;
+	};
+}
+
+#endif //NOVARWGT_EVALCONTEXT_H
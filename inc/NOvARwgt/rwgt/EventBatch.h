@@ -0,0 +1,74 @@
+/*
+ * EventBatch.h:
+ *  Columnar container holding the truth info for many events at once.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_EVENTBATCH_H
+#define NOVARWGT_EVENTBATCH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "NOvARwgt/rwgt/EventRecord.h"
+
+namespace novarwgt
+{
+	/// "Structure-of-arrays" version of novarwgt::EventRecord.
+	///
+	/// Each member vector holds one column (one entry per event).
+	/// Batch readers (e.g. novarwgt::TTreeBatchReader) fill the columns directly,
+	/// and the batch weighting path (e.g. Tune::EventWeights()) unpacks
+	/// one row at a time into a single reused EventRecord via FillRecord(),
+	/// so no per-event objects are ever constructed.
+	///
+	/// The generator information is assumed to be the same for every event in the batch.
+	struct EventBatch
+	{
+		Generator generator = kUnknownGenerator;
+		std::vector<int> generatorVersion;
+		std::string generatorConfigStr;
+
+		std::vector<int> nupdg;
+		std::vector<char> isCC;              ///< char rather than bool so that it's a real contiguous array
+		std::vector<novarwgt::ReactionType> reaction;
+		std::vector<int> struckNucl;
+
+		std::vector<double> Enu;             ///< in GeV
+		std::vector<double> q0;              ///< energy transfer, in GeV
+		std::vector<double> q3;              ///< magnitude of three-momentum transfer, in GeV
+		std::vector<double> y;
+		std::vector<double> W;
+
+		std::vector<unsigned int> A;
+
+		std::vector<int> npiplus;
+		std::vector<int> npizero;
+		std::vector<int> npiminus;
+
+		std::vector<char> expectNoWeights;
+
+		/// Stored GENIE weights, flattened as [event][knob] (knobs in novarwgt::ReweightKnob order).
+		/// Empty if nGenieKnobs == 0.
+		std::vector<novarwgt::ReweightVals> genieWeights;
+		std::vector<char> genieWeightSet;    ///< same layout as genieWeights
+		std::size_t nGenieKnobs = 0;
+
+		/// Number of events in the batch
+		std::size_t size() const { return Enu.size(); }
+
+		/// Resize all the columns.  (Capacity is retained when shrinking, so batches can be reused.)
+		void resize(std::size_t nEvts, std::size_t nKnobs = 0);
+
+		void clear() { resize(0, 0); }
+
+		/// Copy the values for event \a idx into \a rec, overwriting whatever was there.
+		/// Reuses \a rec's existing storage, so calling this repeatedly with the same record doesn't allocate.
+		void FillRecord(std::size_t idx, novarwgt::EventRecord & rec) const;
+	};
+}
+
+#endif //NOVARWGT_EVENTBATCH_H
@@ -10,7 +10,9 @@
 #ifndef NOVARWGT_EVENTRECORD_H
 #define NOVARWGT_EVENTRECORD_H
 
+#include <cstdint>
 #include <limits>
+#include <memory>
 #include <ostream>
 #include <vector>
 
@@ -60,6 +62,35 @@ namespace novarwgt
 		kScDarkMatterDeepInelastic
 	};
 
+	/// Bits in EventRecord::Classification(): the predicates most weighters start by checking.
+	/// Test several at once with masks, e.g. (cls & (kEvtDIS | kEvtHighW)) == (kEvtDIS | kEvtHighW).
+	enum EventClass : std::uint32_t
+	{
+		kEvtCC            = 1u << 0,
+		kEvtNC            = 1u << 1,
+		kEvtNu            = 1u << 2,    ///< nupdg > 0
+		kEvtNubar         = 1u << 3,    ///< nupdg < 0
+		kEvtNuE           = 1u << 4,    ///< either helicity
+		kEvtNuMu          = 1u << 5,
+		kEvtNuTau         = 1u << 6,
+		kEvtQE            = 1u << 7,
+		kEvtRES           = 1u << 8,
+		kEvtDIS           = 1u << 9,
+		kEvtCOH           = 1u << 10,
+		kEvtMEC           = 1u << 11,
+		kEvtFreeNucleon   = 1u << 12,   ///< A == 1 (hydrogen)
+		kEvtStruckProton  = 1u << 13,
+		kEvtStruckNeutron = 1u << 14,
+		kEvt0Pi           = 1u << 15,   ///< npiplus + npizero + npiminus (before FSI).  None of the four is set if that sum is negative
+		kEvt1Pi           = 1u << 16,
+		kEvt2Pi           = 1u << 17,
+		kEvt3PlusPi       = 1u << 18,
+		kEvtLowW          = 1u << 19,   ///< 0 <= W <= 1.7 GeV.  Neither W bit is set for the odd record with W < 0 or NaN
+		kEvtHighW         = 1u << 20,   ///< W >= 1.7 GeV
+	};
+
+	struct StoredWgtSpline;
+
 	//----------------------------------------------------------------------------
 	///  Container for typical precomputed weight tables (-2, -1, +1, +2 sigma)
 	/// (we use floats so that they can be directly casted from the CAF object,
@@ -86,17 +117,20 @@ namespace novarwgt
 			{}
 
 			ReweightList(const ReweightList & other)
-				: fWeights(other.fWeights), fKnobSet(other.fKnobSet)
+				: fWeights(other.fWeights), fKnobSet(other.fKnobSet),
+				  fSplines(other.fSplines)
 			{}
 
 			ReweightList(ReweightList && other) noexcept
-				: fWeights(std::move(other.fWeights)), fKnobSet(std::move(other.fKnobSet))
+				: fWeights(std::move(other.fWeights)), fKnobSet(std::move(other.fKnobSet)),
+				  fSplines(std::move(other.fSplines))
 			{}
 
 			ReweightList& operator=(const ReweightList & other)
 			{
 				fWeights = other.fWeights;
 				fKnobSet = other.fKnobSet;
+				fSplines = other.fSplines;
 
 				return *this;
 			}
@@ -104,16 +138,30 @@ namespace novarwgt
 			ReweightVals &       operator[]( std::size_t pos );
 			const ReweightVals & operator[]( std::size_t pos ) const;
 
-			void clear() { fWeights.clear(); fKnobSet.clear(); }
+			void clear() { fWeights.clear(); fKnobSet.clear(); fSplines.reset(); }
 			void resize(std::size_t size) { fWeights.resize(size); fKnobSet.resize(size); }
 			std::size_t size() const { return fWeights.size(); }
 
 			bool IsSet(std::size_t pos) const { if (pos < fKnobSet.size()) return fKnobSet[pos]; return false; }
 
+			/// Precompute the StoredWgtSpline through the table of each of \a knobs that's set,
+			/// so spline-interpolated GenieSystKnobs for them don't have to rebuild it on every call.
+			/// Splines already built for other knobs are kept.
+			/// Nothing does this unless asked (see BuildGenieWeightSplines() and FillGenieWeightTables()),
+			/// so records only carry splines for the knobs they were requested for.
+			void BuildSplines(const std::vector<novarwgt::ReweightKnob> & knobs);
+
+			/// The spline precomputed by BuildSplines() for knob \a pos,
+			/// or nullptr if there isn't one or the table has been changed since it was built.
+			const StoredWgtSpline * Spline(std::size_t pos) const;
+
 		private:
 			std::vector<ReweightVals>  fWeights;    ///<  The weights
 			std::vector<bool>    fKnobSet;          ///<  Has this knob been set?
 
+			struct SplineCache;
+			std::shared_ptr<const SplineCache> fSplines;  ///<  Splines through some of the weights (see BuildSplines()).  Never modified once built, so copies share it
+
 			const ReweightVals fNaNVals = ReweightVals{std::numeric_limits<float>::signaling_NaN(),
 			                                           std::numeric_limits<float>::signaling_NaN(),
 			                                           std::numeric_limits<float>::signaling_NaN(),
@@ -168,17 +216,47 @@ namespace novarwgt
 			new (this) EventRecord();
 		}
 
-		double Q2() const
-		{
-			if (std::isnan(this->q2))
-				this->q2 = q.Mag2();
-			return -this->q2;
-		}
-
 		const genie::EventRecord * origGenieEvt = nullptr;   ///< If this event was made from a GENIE event, this is it.
 
+		/// Mark the record as (re)filled by giving it a new Serial() and working out its Classification().
+		/// The converters and EventBatch::FillRecord() call this; if you fill or modify a record yourself,
+		/// call it again afterwards.
+		/// Nothing is ever filled in lazily, so a finalized record can be read from any number of threads at once.
+		void Finalize();
+
+		// the derived kinematics are always worked out from the fields above,
+		// so they can't go stale when a record is modified
+
+		/// Energy transfer q0, in GeV
+		double q0() const { return q.E(); }
+
+		/// Magnitude of the three-momentum transfer |q|, in GeV
+		double q3() const { return q.P(); }
+
+		/// Four-momentum transfer squared, Q^2 = -q^2, in GeV^2
+		double Q2() const { return -q.Mag2(); }
+
+		/// Hadronic invariant mass squared, in GeV^2
+		double W2() const { return W * W; }
+
+		/// Bitmask of EventClass bits describing this event.
+		/// Stored by Finalize(), so it's as of the last Finalize() call (like Serial());
+		/// a record that's never been finalized works it out from the fields on every call instead.
+		std::uint32_t Classification() const { return fClassBits ? fClassBits : Classify(); }
+
+		/// Number identifying the current contents of this record.
+		/// Every new record gets a fresh one, and so does a record that's refilled through Finalize() or Reset(),
+		/// so caches of per-event results (EvalContext) can tell a record refilled in place from the one before.
+		/// (Copies share the serial of their source, which is fine since the contents are the same.)
+		std::uint64_t Serial() const { return fSerial; }
+
 		private:
-			mutable double q2 = std::numeric_limits<double>::signaling_NaN();
+			static std::uint64_t NextSerial();
+
+			std::uint32_t Classify() const;
+
+			std::uint64_t fSerial = NextSerial();
+			std::uint32_t fClassBits = 0;   ///< 0 until Finalize(): every classified record is either kEvtCC or kEvtNC
 	};
 }
 
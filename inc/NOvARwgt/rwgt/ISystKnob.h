@@ -10,8 +10,12 @@
 #ifndef NOVARWGT_ISYSTKNOB_H
 #define NOVARWGT_ISYSTKNOB_H
 
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
 #include <string>
 #include <numeric>
+#include <vector>
 
 #include "NOvARwgt/rwgt/IWeightGenerator.h"
 
@@ -20,6 +24,16 @@
 
 namespace novarwgt
 {
+	/// Result of ISystKnob::GetWeightAndDerivative()
+	struct WeightAndDerivative
+	{
+		double weight;
+		double derivative;   ///< d(weight)/d(sigma)
+	};
+
+	// forward declaration
+	class ISystKnobFamily;
+
 	class ISystKnob : public novarwgt::IRegisterable, public novarwgt::ITestGenVersion
 	{
 		public:
@@ -32,11 +46,68 @@ namespace novarwgt
 
 				TestIfEvtGenIsSupported(ev, otherParams);
 
-				double wgt = CalcWeight(sigma, ev, otherParams);
+				return Clamp(CalcWeight(sigma, ev, otherParams));
+			}
+
+			/// Request the weight for this knob for given event at given sigma,
+			/// together with its derivative with respect to sigma (for gradient-based fitters).
+			/// Where the weight is clamped, the derivative is 0.
+			WeightAndDerivative GetWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const
+			{
+				if (ev.expectNoWeights)
+					return {1.0, 0.0};
 
-				return std::min(std::max(wgt, fClampRange.first), fClampRange.second);
+				TestIfEvtGenIsSupported(ev, otherParams);
+
+				WeightAndDerivative wd = CalcWeightAndDerivative(sigma, ev, otherParams);
+				if (wd.weight < fClampRange.first)
+					return {fClampRange.first, 0.0};
+				else if (wd.weight > fClampRange.second)
+					return {fClampRange.second, 0.0};
+				return wd;
+			}
+
+			/// Weights of this knob for one event at many sigmas (e.g., one per random universe).
+			/// Same as calling GetWeight() for each of them, but the support check is only done once,
+			/// and knobs can share the rest of the work between the sigmas too (see CalcWeights()).
+			/// \param sigmas  \a n sigma values
+			/// \param wgts    Output: \a n weights
+			void GetWeights(const double * sigmas, std::size_t n, const novarwgt::EventRecord &ev,
+			                const novarwgt::InputVals &otherParams, double * wgts) const
+			{
+				if (ev.expectNoWeights)
+				{
+					std::fill(wgts, wgts + n, 1.0);
+					return;
+				}
+
+				TestIfEvtGenIsSupported(ev, otherParams);
+
+				CalcWeights(sigmas, n, ev, otherParams, wgts);
+
+				const double lo = fClampRange.first;
+				const double hi = fClampRange.second;
+				for (std::size_t idx = 0; idx < n; idx++)
+					wgts[idx] = std::min(std::max(wgts[idx], lo), hi);
 			}
 
+			/// Can this knob change the weight of \a ev at all?
+			///
+			/// Members of an ISystKnobFamily are answered from the family's slot for the event, without evaluating them.
+			/// Any other knob is evaluated at 0, +-1 and +-2 sigma, and is taken to affect the event
+			/// if it's not 1 at one of them.  (A knob that was 1 at every one of those but not in between them
+			/// would be missed; none of the knobs here behave like that.)
+			/// Used to skip knobs that don't apply to an event before evaluating them many times over.
+			/// Like GetWeight(), throws if the event's generator isn't supported.
+			bool CanAffect(const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const;
+
+			/// Weighters this knob gets weights from: the CV weights it's relative to, plus any others it uses.
+			/// (See IWeightGenerator::Dependencies().)
+			virtual std::vector<const novarwgt::IWeightGenerator*> Dependencies() const { return fCVWgts; }
+
+			/// The family this knob belongs to, if any (see ISystKnobFamily)
+			virtual const ISystKnobFamily * Family() const { return nullptr; }
+
 		protected:
 			/// Build a syst knob.  Note that this constructor is not callable directly; use GetSystKnob() instead.
 			/// \param name        Short name
@@ -58,6 +129,51 @@ namespace novarwgt
 			/// Actually compute the weight in derived classes.
 			virtual double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const = 0;
 
+			/// Compute the weights at many sigmas in derived classes (see GetWeights(); clamping is done there).
+			/// The default computes the slope once for knobs that are IsAffine() and otherwise calls CalcWeight() for each sigma.
+			virtual void CalcWeights(const double * sigmas, std::size_t n, const novarwgt::EventRecord &ev,
+			                         const novarwgt::InputVals &otherParams, double * wgts) const
+			{
+				if (IsAffine())
+				{
+					const double slope = CalcWeightAndDerivative(0, ev, otherParams).derivative;
+					for (std::size_t idx = 0; idx < n; idx++)
+						wgts[idx] = 1 + sigmas[idx] * slope;
+					return;
+				}
+
+				for (std::size_t idx = 0; idx < n; idx++)
+					wgts[idx] = CalcWeight(sigmas[idx], ev, otherParams);
+			}
+
+			/// Is the (unclamped) weight exactly 1 + sigma * slope for every sigma, with a slope depending only on the event?
+			/// If so, CalcWeightAndDerivative() at sigma = 0 gives the slope, which the default CalcWeights() relies on.
+			virtual bool IsAffine() const { return false; }
+
+			/// Compute the weight and its derivative in derived classes.
+			/// The default uses a central finite difference, which costs two extra evaluations;
+			/// knobs whose derivative is known analytically should override it.
+			///
+			/// Many knobs are affine in sigma: weight = 1 + sigma * slope, with a slope depending only on the event.
+			/// Those keep the slope in a private Slope() helper that both CalcWeight() and this use,
+			/// so this returns {1 + sigma * Slope(), Slope()} without repeating CalcWeight()'s logic
+			/// (and they say so with IsAffine()).
+			/// Knobs that are only affine over part of the sigma range (clamped or one-sided)
+			/// return a derivative of 0 outside it, and aren't IsAffine().
+			virtual WeightAndDerivative CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const
+			{
+				const double h = 1e-4;
+				return { CalcWeight(sigma, ev, otherParams),
+				         (CalcWeight(sigma + h, ev, otherParams) - CalcWeight(sigma - h, ev, otherParams)) / (2 * h) };
+			}
+
+			/// Clamp \a wgt to the range given at construction
+			double Clamp(double wgt) const
+			{
+				return std::min(std::max(wgt, fClampRange.first), fClampRange.second);
+			}
+
+			/// Product of the CV weights.  Within an EvalContextScope, each of them is only computed once per event.
 			double CVWgt(const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const
 			{
 				return std::accumulate(fCVWgts.begin(), fCVWgts.end(), 1.0,
@@ -72,6 +188,79 @@ namespace novarwgt
 			std::vector<const novarwgt::IWeightGenerator*> fCVWgts;
 	};
 
+	// ---------------------------------------------------------------------
+	/// A set of knobs declared together, each of which only affects its own, non-overlapping class of events
+	/// (e.g., the DISnPionSyst knobs, one per pion multiplicity x nu/nubar x CC/NC x struck nucleon).
+	///
+	/// Rather than asking every member whether it applies to an event, the family classifies the event once
+	/// into the 'slot' of the only member that can affect it.  Tune uses this to evaluate only that member
+	/// (see Tune::ShiftedEventWeight()); the rest of the family is 1 for the event.
+	class ISystKnobFamily
+	{
+		public:
+			/// Returned by Slot() for events none of the members affect
+			static constexpr int kNoSlot = -1;
+
+			virtual ~ISystKnobFamily() = default;
+
+			/// The members, indexed by slot
+			const std::vector<const ISystKnob*> & Members() const { return fMembers; }
+
+			/// Slot of \a knob in this family, or kNoSlot if it's not a member
+			int SlotOf(const ISystKnob * knob) const
+			{
+				auto itKnob = std::find(fMembers.begin(), fMembers.end(), knob);
+				return (itKnob == fMembers.end()) ? kNoSlot : int(itKnob - fMembers.begin());
+			}
+
+			/// Slot of the member that can affect \a ev, or kNoSlot if none of them can
+			virtual int Slot(const novarwgt::EventRecord & ev) const = 0;
+
+			/// Throw, as the members' GetWeight() would, if any member doesn't support \a ev's generator.
+			/// Needed for every event, even those in no slot, since the members' GetWeight() would check those too.
+			/// Families whose members all share one support configuration can override this to check only once.
+			virtual void TestIfEvtGenIsSupported(const novarwgt::EventRecord & ev, const novarwgt::InputVals & params = {}) const
+			{
+				if (ev.expectNoWeights)
+					return;
+				for (const auto & member : fMembers)
+					member->TestIfEvtGenIsSupported(ev, params);
+			}
+
+			/// Weight of the member in \a slot for \a ev, which must be an event in that slot.
+			/// Same as that member's GetWeight() (clamping included), but families can skip re-checking
+			/// which events it applies to, and needn't repeat the support check:
+			/// call TestIfEvtGenIsSupported() for the event first.
+			virtual double SlotWeight(int slot, double sigma, const novarwgt::EventRecord & ev, const novarwgt::InputVals & params = {}) const
+			{
+				return fMembers[slot]->GetWeight(sigma, ev, params);
+			}
+
+		protected:
+			std::vector<const ISystKnob*> fMembers;
+	};
+
+	// ---------------------------------------------------------------------
+	inline bool ISystKnob::CanAffect(const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams) const
+	{
+		if (ev.expectNoWeights)
+			return false;
+
+		if (const ISystKnobFamily * family = Family())
+		{
+			TestIfEvtGenIsSupported(ev, otherParams);   // GetWeight() would have, whatever the slot
+			return family->Slot(ev) == family->SlotOf(this);
+		}
+
+		const double probeSigmas[] = {0, -1, 1, -2, 2};
+		for (const double sigma : probeSigmas)
+		{
+			if (GetWeight(sigma, ev, otherParams) != 1)
+				return true;
+		}
+		return false;
+	}
+
 	// ---------------------------------------------------------------------
 
 	/// Get me a syst knob!  (Just an alias for GetRegisterable(), really, but makes the intent clearer)
@@ -97,17 +286,55 @@ namespace novarwgt
 	}
 
 	// ---------------------------------------------------------------------
-	/// Save some typing
-	typedef std::unordered_set<const ISystKnob*> SystKnobSet;
+	/// A collection of distinct syst knobs.
+	///
+	/// Knobs stay in the order they were added in (duplicates are dropped),
+	/// so anything built from a set (e.g., a Tune's list of knobs) comes out in the same order every run,
+	/// rather than depending on where in memory the knobs happen to live.
+	class SystKnobSet
+	{
+		public:
+			typedef std::vector<const ISystKnob*>::const_iterator const_iterator;
+
+			SystKnobSet() = default;
+
+			SystKnobSet(std::initializer_list<const ISystKnob*> knobs)
+			{
+				for (const auto & knob : knobs)
+					insert(knob);
+			}
+
+			/// Add a knob at the end, unless it's already present.  Returns whether it was added.
+			bool insert(const ISystKnob * knob)
+			{
+				if (count(knob))
+					return false;
+				fKnobs.push_back(knob);
+				return true;
+			}
+
+			std::size_t count(const ISystKnob * knob) const
+			{
+				return std::find(fKnobs.begin(), fKnobs.end(), knob) != fKnobs.end() ? 1 : 0;
+			}
+
+			std::size_t size() const { return fKnobs.size(); }
+			bool empty() const { return fKnobs.empty(); }
+
+			const_iterator begin() const { return fKnobs.begin(); }
+			const_iterator end() const { return fKnobs.end(); }
+
+		private:
+			std::vector<const ISystKnob*> fKnobs;
+	};
 
 	/// Enable combining SystKnobSets with 's1 | s2' syntax.
+	/// The result has the knobs of \a r1, followed by those of \a r2 that aren't in \a r1.
 	inline SystKnobSet operator|(const SystKnobSet& r1, const SystKnobSet& r2)
 	{
-		SystKnobSet ret;
-		std::set_union(r1.begin(), r1.end(),
-		               r2.begin(), r2.end(),
-		               std::inserter(ret, ret.end())
-		);
+		SystKnobSet ret(r1);
+		for (const auto & knob : r2)
+			ret.insert(knob);
 
 		return ret;
 	}
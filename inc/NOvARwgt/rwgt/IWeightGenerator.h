@@ -16,7 +16,9 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
+#include "NOvARwgt/rwgt/EvalContext.h"
 #include "NOvARwgt/rwgt/EventRecord.h"
 #include "NOvARwgt/util/Exceptions.h"
 #include "NOvARwgt/util/Hash.h"
@@ -48,11 +50,26 @@ namespace novarwgt
 				if (ev.expectNoWeights)
 					return 1.0;
 
+				// if this weighter already ran for this event, don't do it again
+				EvalContext * ctx = EvalContext::Active();
+				if (ctx && !ctx->Matches(ev, otherParams))
+					ctx = nullptr;
+				double wgt;
+				if (ctx && ctx->Find(this, wgt))
+					return wgt;
+
 				TestIfEvtGenIsSupported(ev, otherParams);
 
-				return CalcWeight(ev, otherParams);
+				wgt = CalcWeight(ev, otherParams);
+				if (ctx)
+					ctx->Store(this, wgt);
+				return wgt;
 			}
 
+			/// Other weighters this one gets weights from (via their GetWeight()) when computing its own.
+			/// Tune uses these to work out which weighters it needs to evaluate for each event, and in what order.
+			virtual std::vector<const IWeightGenerator*> Dependencies() const { return {}; }
+
 			virtual ~IWeightGenerator() = default;
 
 		protected:
@@ -0,0 +1,119 @@
+/*
+ * SpectrumAccumulator.h:
+ *  Weights events and fills CV + systematically shifted spectra with them in one fused pass.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_SPECTRUMACCUMULATOR_H
+#define NOVARWGT_SPECTRUMACCUMULATOR_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "NOvARwgt/util/InputVals.h"
+
+class TH1;
+
+namespace novarwgt
+{
+	// forward declarations
+	struct EventBatch;
+	struct EventRecord;
+	class ISystKnob;
+	class Tune;
+	class WorkerPool;
+
+	/// One systematically shifted spectrum: knob \a knob (by name, as in Tune::KnobNames()) at \a sigma
+	struct KnobShift
+	{
+		std::string knob;
+		double sigma;
+	};
+
+	/// \brief Fills the CV spectrum and one spectrum per knob shift directly from events.
+	///
+	/// Each event's CV weight and shifted weights are computed and immediately added into
+	/// the spectra, so the [event x shift] weight array never exists.  Events the binning function
+	/// rejects aren't weighted at all.
+	///
+	/// Accumulate() splits the batch into fixed-size chunks of kChunkSize events, which the threads share out;
+	/// each chunk is summed into its own partial spectra, which are then added into the totals in chunk order.
+	/// So the result only depends on the events, not on how many threads there are or how they get scheduled.
+	///
+	/// Usage:
+	/// \code
+	///   novarwgt::SpectrumAccumulator acc(novarwgt::kCVTune2018, 50,
+	///                                     [](const novarwgt::EventRecord & ev) { return int(ev.Enu / 0.1); },
+	///                                     {{"MaCCQE", -1}, {"MaCCQE", +1}});
+	///   for (Long64_t entry = 0; reader.ReadBatch(entry, 10000, batch) > 0; entry += 10000)
+	///     acc.Accumulate(batch);
+	///   acc.FillHist(0, cvHist);
+	/// \endcode
+	class SpectrumAccumulator
+	{
+		public:
+			/// Returns the bin (0 to nBins-1) the event belongs in; anything else means 'don't fill'
+			typedef std::function<int(const novarwgt::EventRecord &)> BinFunction;
+
+			/// \param tune    Tune providing the CV weight and the knobs
+			/// \param nBins   Number of bins in each spectrum
+			/// \param binFn   Binning function
+			/// \param shifts  Knob shifts to make spectra for
+			/// \param params  Any other needed parameters not in the events
+			SpectrumAccumulator(const novarwgt::Tune & tune,
+			                    std::size_t nBins,
+			                    BinFunction binFn,
+			                    const std::vector<novarwgt::KnobShift> & shifts,
+			                    novarwgt::InputVals params = {});
+
+			/// Number of events per chunk (see above)
+			static constexpr std::size_t kChunkSize = 1024;
+
+			/// Weight the events in \a batch and add them to the spectra.  Can be called for as many batches as needed.
+			/// \param nThreads  Number of threads to use (0 = as many as the hardware supports).
+			///                  They come from WorkerPool::Shared(), so they're kept from one call to the next;
+			///                  1 means the calling thread.
+			void Accumulate(const novarwgt::EventBatch & batch, unsigned int nThreads = 0);
+
+			/// As above, but run on the workers of a caller-supplied \a pool.
+			void Accumulate(const novarwgt::EventBatch & batch, novarwgt::WorkerPool & pool);
+
+			/// Number of spectra: the CV (index 0), followed by one per shift in the order they were given
+			std::size_t NSpectra() const { return 1 + fShiftKnobs.size(); }
+
+			std::size_t NBins() const { return fNBins; }
+
+			/// Sum of weights in each bin of spectrum \a specIdx
+			std::vector<double> Contents(std::size_t specIdx) const;
+
+			/// Sum of squared weights in each bin of spectrum \a specIdx
+			std::vector<double> SumW2(std::size_t specIdx) const;
+
+			/// Copy spectrum \a specIdx into ROOT histogram bins 1 to NBins() (contents and errors)
+			void FillHist(std::size_t specIdx, TH1 * hist) const;
+
+			/// Empty all the spectra
+			void Reset();
+
+		private:
+			/// Implementation of Accumulate().  A null \a pool means "use the calling thread".
+			void AccumulateChunks(const novarwgt::EventBatch & batch, novarwgt::WorkerPool * pool);
+
+			const novarwgt::Tune & fTune;
+			std::size_t fNBins;
+			BinFunction fBinFn;
+			novarwgt::InputVals fParams;
+
+			std::vector<const novarwgt::ISystKnob*> fShiftKnobs;
+			std::vector<double> fShiftSigmas;
+
+			std::vector<double> fSumW;    ///< [spectrum][bin]
+			std::vector<double> fSumW2;   ///< [spectrum][bin]
+	};
+}
+
+#endif //NOVARWGT_SPECTRUMACCUMULATOR_H
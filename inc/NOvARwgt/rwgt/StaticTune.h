@@ -0,0 +1,123 @@
+/*
+ * StaticTune.h:
+ *  Compile-time alternative to Tune for fixed sets of weighters.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_STATICTUNE_H
+#define NOVARWGT_STATICTUNE_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "NOvARwgt/rwgt/EventRecord.h"
+#include "NOvARwgt/rwgt/IWeightGenerator.h"
+#include "NOvARwgt/util/InputVals.h"
+
+namespace novarwgt
+{
+	/// \brief A tune whose weighters are fixed at compile time.
+	///
+	/// Tune keeps its weighters in a string-keyed map and calls each through the virtual
+	/// IWeightGenerator::GetWeight(), building a vector of named weights along the way.
+	/// For the shipped tunes none of that flexibility is needed: here the weighter types are
+	/// template parameters, and each one's CalcWeight() is called by its qualified name,
+	/// so there's no virtual dispatch, no lookup and no allocation, and the compiler can inline
+	/// everything it can see into a single per-event function.
+	/// That is all it saves, though: each weighter still checks that it supports the event's generator
+	/// (IWeightGenerator::TestIfEvtGenIsSupported()) for every event, just as it does under Tune,
+	/// since the supported generators differ from weighter to weighter.
+	///
+	/// The results are the same as for the equivalent Tune (except that the EvalContext memo is bypassed).
+	/// Each of the shipped tunes is also available in this form (e.g., kStaticCVTune2018 in Tunes2018.h).
+	///
+	/// Usage:
+	/// \code
+	///   novarwgt::StaticTune<novarwgt::MAQEWeight_2018, novarwgt::HighWDISWgt_2018>
+	///       tune(novarwgt::GetWeighter<novarwgt::MAQEWeight_2018>(), novarwgt::GetWeighter<novarwgt::HighWDISWgt_2018>());
+	///   double wgt = tune.EventWeight(ev);
+	/// \endcode
+	template <typename ... Weighters>
+	class StaticTune
+	{
+		static_assert(sizeof...(Weighters) > 0, "StaticTune: need at least one weighter");
+
+		public:
+			/// Number of weighters
+			static constexpr std::size_t NWeighters = sizeof...(Weighters);
+
+			/// \param wgtrs  The weighters, usually from GetWeighter()
+			explicit StaticTune(const Weighters * ... wgtrs)
+				: fWgtrs(wgtrs...)
+			{}
+
+			/// Product of all the weighters' weights
+			double EventWeight(const novarwgt::EventRecord & evt, const novarwgt::InputVals & params = {}) const
+			{
+				// some events don't have enough truth info to be useful
+				if (evt.expectNoWeights)
+					return 1.0;
+
+				return EventWeightImpl(evt, params, std::index_sequence_for<Weighters...>{});
+			}
+
+			/// Weight from each weighter separately, in template-parameter order.
+			/// \param wgts  Output: NWeighters entries
+			void EventWeightComponents(const novarwgt::EventRecord & evt, double * wgts, const novarwgt::InputVals & params = {}) const
+			{
+				if (evt.expectNoWeights)
+				{
+					for (std::size_t idx = 0; idx < NWeighters; idx++)
+						wgts[idx] = 1.0;
+					return;
+				}
+
+				ComponentsImpl(evt, params, wgts, std::index_sequence_for<Weighters...>{});
+			}
+
+			/// The \a Idx-th weighter
+			template <std::size_t Idx>
+			const typename std::tuple_element<Idx, std::tuple<Weighters...>>::type * Get() const
+			{
+				return std::get<Idx>(fWgtrs);
+			}
+
+		private:
+			template <typename W>
+			static double Eval(const W * wgtr, const novarwgt::EventRecord & evt, const novarwgt::InputVals & params)
+			{
+				static_assert(std::is_base_of<novarwgt::IWeightGenerator, W>::value,
+				              "StaticTune: weighters must derive from novarwgt::IWeightGenerator");
+
+				wgtr->TestIfEvtGenIsSupported(evt, params);   // per weighter, per event, as in Tune
+				return wgtr->W::CalcWeight(evt, params);   // qualified call: no virtual dispatch
+			}
+
+			template <std::size_t ... Idx>
+			double EventWeightImpl(const novarwgt::EventRecord & evt, const novarwgt::InputVals & params, std::index_sequence<Idx...>) const
+			{
+				double wgt = 1.0;
+				int dummy[] = {0, (wgt *= Eval(std::get<Idx>(fWgtrs), evt, params), 0)...};
+				(void) dummy;
+				return wgt;
+			}
+
+			template <std::size_t ... Idx>
+			void ComponentsImpl(const novarwgt::EventRecord & evt, const novarwgt::InputVals & params, double * wgts, std::index_sequence<Idx...>) const
+			{
+				int dummy[] = {0, (wgts[Idx] = Eval(std::get<Idx>(fWgtrs), evt, params), 0)...};
+				(void) dummy;
+			}
+
+			std::tuple<const Weighters*...> fWgtrs;
+	};
+
+	template <typename ... Weighters>
+	constexpr std::size_t StaticTune<Weighters...>::NWeighters;
+}
+
+#endif //NOVARWGT_STATICTUNE_H
@@ -22,8 +22,47 @@
 namespace novarwgt
 {
 	// forward declarations
+	struct EventBatch;
 	struct EventRecord;
 
+	/// Position of a knob within a Tune (from Tune::FindKnob()).
+	/// Resolve names to handles once, outside the event loop; a handle is only meaningful for the Tune that made it.
+	struct KnobHandle
+	{
+		std::size_t idx;
+	};
+
+	/// Position of a CV weighter within a Tune (from Tune::FindWeighter())
+	struct WeighterHandle
+	{
+		std::size_t idx;
+	};
+
+	/// A collection of CV weighters and the syst knobs that go with them.
+	///
+	/// Each of the weight methods evaluates its weighters inside an EvalContextScope,
+	/// so a weighter used in several places (e.g., the CV weights that knobs are relative to)
+	/// only runs once per call.  To share the results across several calls for the same event
+	/// (the CV weight and every knob, say), set up a scope around all of them:
+	/// \code
+	///   novarwgt::EvalContext ctx;   // reuse across events
+	///   for (const auto & evt : events)
+	///   {
+	///     novarwgt::EvalContextScope scope(ctx, evt, params);
+	///     double cv = tune.EventWeight(evt, params);
+	///     for (std::size_t knobIdx = 0; knobIdx < tune.KnobNames().size(); knobIdx++)
+	///       ... tune.EventSystKnobWeight(novarwgt::KnobHandle{knobIdx}, 1, evt, params) ...
+	///   }
+	/// \endcode
+	///
+	/// The weighters and knobs are kept in the order they were declared in
+	/// (see SystKnobSet), so component and knob indices are the same from run to run.
+	///
+	/// On construction the tune also compiles an evaluation plan: every weighter reachable from
+	/// the CV weighters and the knobs (through IWeightGenerator::Dependencies() and ISystKnob::Dependencies()),
+	/// each listed once, ordered so that every weighter comes after the ones it depends on.
+	/// Methods that need the whole tune for an event (ShiftedEventWeight(), or user code via EvaluatePlan())
+	/// evaluate the plan once up front, so that the CV and the knobs only combine weights that are already known.
 	class Tune
 	{
 		public:
@@ -41,44 +80,137 @@ namespace novarwgt
 				                                           const novarwgt::InputVals &)>
 				FunctionType;
 
-			explicit Tune(std::unordered_map<std::string, const novarwgt::IWeightGenerator*>  wgts,
+			/// \param wgts   The CV weighters, each with a short name.  Duplicate names after the first are ignored.
+			/// \param knobs  The syst knobs.  Knobs with the same name as an earlier one are ignored.
+			explicit Tune(std::vector<std::pair<std::string, const novarwgt::IWeightGenerator*>> wgts,
 			              SystKnobSet knobs = {});
 
-			/// Returns the product of the weights calculated in Tune::EventWeightComponents
+			/// Returns the product of the weights calculated in Tune::EventWeightComponents.
+			/// Doesn't allocate anything on the heap (once the thread's EvalContext has grown to size).
 			double EventWeight(const novarwgt::EventRecord & evt, const novarwgt::InputVals & params = {}) const;
 
+			/// Batch version of EventWeight(): compute the weight for every event in \a batch.
+			/// \param batch   Events to weight
+			/// \param wgts    Output; resized to batch.size()
+			/// \param params  Any other needed parameters not in the events
+			void EventWeights(const novarwgt::EventBatch & batch,
+			                  std::vector<double> & wgts,
+			                  const novarwgt::InputVals & params = {}) const;
+
 			/// Workhorse method that uses the provided function to calculate the set of weights.
+			/// The weights come out in the same order as WeighterNames().
 			std::vector<NamedWeight>
 			    EventWeightComponents(const novarwgt::EventRecord & evt, const novarwgt::InputVals & params = {}) const;
 
+			/// Non-allocating version of the above: the weight from each weighter is written into \a wgts,
+			/// at the index of its WeighterHandle (i.e., in WeighterNames() order).
+			/// \param wgts   Output buffer
+			/// \param nWgts  Size of the buffer; must be at least WeighterNames().size()
+			void EventWeightComponents(const novarwgt::EventRecord & evt,
+			                           double * wgts,
+			                           std::size_t nWgts,
+			                           const novarwgt::InputVals & params = {}) const;
+
+			/// Weight from one CV weighter
+			double EventWeighterWeight(WeighterHandle wgtr, const novarwgt::EventRecord & evt, const novarwgt::InputVals & params = {}) const;
+
 			/// Get the weight for a specific knob.
-			/// \param knobName       The name of the knob.  (See KnobNames() for a full list.)
+			/// \param knob           The knob (see FindKnob())
 			/// \param sigma          Number of sigma away from nominal you want the weight for
 			/// \param evt            Event in question
 			/// \param params         Any other needed parameters not in the event
 			/// \param relativeToCV   Should this weight be given as an absolute event weight (default) or relative to the CV weight for this tune?
 			/// \return               The requested weight
+			double EventSystKnobWeight(KnobHandle knob,
+			                           double sigma,
+			                           const novarwgt::EventRecord & evt,
+			                           const novarwgt::InputVals & params = {},
+			                           bool relativeToCV = false) const;
+
+			/// Same as above, but looking the knob up by name (see KnobNames()) on every call.
+			/// Prefer resolving a KnobHandle once with FindKnob() in event loops.
 			double EventSystKnobWeight(const std::string & knobName,
 			                           double sigma,
 			                           const novarwgt::EventRecord & evt,
 			                           const novarwgt::InputVals & params = {},
 			                           bool relativeToCV = false) const;
 
+			/// Get the combined weight for shifting all of this tune's knobs at once
+			/// (i.e., the product of the individual knob weights), as needed by fits.
+			///
+			/// This is much cheaper than multiplying together EventSystKnobWeight() calls:
+			/// no knobs are looked up by name, each weighter (including the CV weights that knobs are
+			/// computed relative to) is evaluated only once for the event, however many knobs use it,
+			/// and for knobs that belong to an ISystKnobFamily only the one member that applies to the event is evaluated.
+			/// \param evt            Event in question
+			/// \param sigmas         Number of sigma for each knob, in the order of KnobNames() (every knob must be given)
+			/// \param params         Any other needed parameters not in the event
+			/// \param relativeToCV   As in EventSystKnobWeight()
+			/// \return               The product of the requested knob weights
+			double ShiftedEventWeight(const novarwgt::EventRecord & evt,
+			                          const std::vector<double> & sigmas,
+			                          const novarwgt::InputVals & params = {},
+			                          bool relativeToCV = false) const;
+
 			/// Get a full list of this Tune's relevant systematic knobs' names
 			const std::vector<std::string> & KnobNames() const;
 
-			/// Get the syst knobs associated with this tune
-			const std::unordered_map<std::string, const novarwgt::ISystKnob *> & SystKnobs() const;
+			/// Get the syst knobs associated with this tune, in the same order as KnobNames()
+			const std::vector<const novarwgt::ISystKnob *> & SystKnobs() const;
+
+			/// Names of the CV weighters, in declaration order
+			const std::vector<std::string> & WeighterNames() const;
+
+			/// Look up a knob by name.  Throws if this tune has no such knob.
+			KnobHandle FindKnob(const std::string & knobName) const;
+
+			/// Look up a CV weighter by name.  Throws if this tune has no such weighter.
+			WeighterHandle FindWeighter(const std::string & wgtrName) const;
+
+			const novarwgt::ISystKnob * Knob(KnobHandle knob) const { return fSystKnobs.at(knob.idx); }
+			const novarwgt::IWeightGenerator * Weighter(WeighterHandle wgtr) const { return fWeighters.at(wgtr.idx); }
+
+			/// Every weighter this tune uses, directly or indirectly, in dependency order (see class description)
+			const std::vector<const novarwgt::IWeightGenerator*> & EvaluationPlan() const { return fPlan; }
+
+			/// Evaluate each weighter in EvaluationPlan() for \a evt, storing the weights in the active EvalContext.
+			/// Only useful inside an EvalContextScope for \a evt and \a params (it does nothing otherwise);
+			/// later calls to EventWeight(), EventSystKnobWeight() etc. in the same scope then don't compute anything new.
+			/// Weighters that don't support the event's generator are skipped.
+			void EvaluatePlan(const novarwgt::EventRecord & evt, const novarwgt::InputVals & params = {}) const;
 
 		private:
-			/// This Tune's constituent CV weights.
-			std::unordered_map<std::string, const novarwgt::IWeightGenerator*> fWeighters;
+			/// Build fPlan from the weighters and knobs
+			void CompilePlan();
 
-			/// This Tune's relevant systematic knobs.
-			std::unordered_map<std::string, const novarwgt::ISystKnob*> fSystKnobs;
+			/// Sort the knobs into fLoneKnobs and fKnobFamilies
+			void GroupKnobFamilies();
 
-			/// Internal-use only list of knob names.  Filled from fSystKnobs in the constructor.
+			/// This Tune's constituent CV weights, and their names.
+			std::vector<const novarwgt::IWeightGenerator*> fWeighters;
+			std::vector<std::string> fWeighterNames;
+
+			/// This Tune's relevant systematic knobs, and their names.
+			std::vector<const novarwgt::ISystKnob*> fSystKnobs;
 			std::vector<std::string> fSystKnobNames;
+
+			/// Only used to resolve names to handles
+			std::unordered_map<std::string, std::size_t> fWeighterIdxs;
+			std::unordered_map<std::string, std::size_t> fSystKnobIdxs;
+
+			/// All the weighters, dependencies first
+			std::vector<const novarwgt::IWeightGenerator*> fPlan;
+
+			/// The knobs of one ISystKnobFamily that are in this tune
+			struct KnobFamily
+			{
+				const novarwgt::ISystKnobFamily * family;
+				std::vector<std::size_t> knobIdxs;   ///< index into fSystKnobs for each slot (fSystKnobs.size() if not in this tune)
+			};
+
+			/// Indices of knobs that aren't in any family, and the families the rest are in
+			std::vector<std::size_t> fLoneKnobs;
+			std::vector<KnobFamily> fKnobFamilies;
 	};
 
 }
@@ -0,0 +1,100 @@
+/*
+ * UniverseThrower.h:
+ *  Random "universes" (sigma vectors for all of a Tune's knobs) evaluated for each event in a single pass.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_UNIVERSETHROWER_H
+#define NOVARWGT_UNIVERSETHROWER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "NOvARwgt/util/InputVals.h"
+
+class TH1;
+
+namespace novarwgt
+{
+	// forward declarations
+	struct EventRecord;
+	class ISystKnob;
+	class Tune;
+
+	/// \brief Throws many random universes across all of a Tune's knobs and weights events in all of them at once.
+	///
+	/// The sigma vectors are drawn once, up front, from a seeded generator (so the same seed always gives
+	/// the same universes), either independently for each knob or with a given covariance between them.
+	/// Each event is then weighted in every universe in one loop: knob by knob, over all the universes,
+	/// with the CV weighters the knobs depend on shared across all of them (see EvalContext).
+	/// Members of a knob family (ISystKnob::Family()) whose slot isn't the event's are skipped; the rest are evaluated
+	/// in all universes at once with ISystKnob::GetWeights(), so e.g. affine knobs work out their slope only once.
+	///
+	/// The weights are total event weights, i.e., CV weight x the weights of all the knobs at the universe's sigmas.
+	///
+	/// Usage:
+	/// \code
+	///   novarwgt::UniverseThrower universes(novarwgt::kCVTune2018, 500, 12345);
+	///   std::vector<double> wgts;   // [event][universe]
+	///   universes.Weights(events, wgts);
+	/// \endcode
+	class UniverseThrower
+	{
+		public:
+			/// Throw universes in which the knobs are uncorrelated and each has a unit Gaussian distribution
+			/// \param tune        The tune providing the CV weight and the knobs
+			/// \param nUniverses  How many universes to throw
+			/// \param seed        Seed for the random number generator
+			UniverseThrower(const novarwgt::Tune & tune, std::size_t nUniverses, unsigned int seed);
+
+			/// Throw correlated universes.
+			/// \param covariance  nKnobs x nKnobs covariance matrix (in units of sigma, so its diagonal is usually all 1s),
+			///                    flattened row by row, with knobs in Tune::KnobNames() order.
+			///                    Must be symmetric and positive definite.
+			UniverseThrower(const novarwgt::Tune & tune, std::size_t nUniverses, unsigned int seed,
+			                const std::vector<double> & covariance);
+
+			std::size_t NUniverses() const { return fNUniverses; }
+
+			/// Names of the knobs, in the order they're indexed by here (the same as Tune::KnobNames())
+			const std::vector<std::string> & KnobNames() const { return fKnobNames; }
+
+			/// The sigma thrown for \a knobIdx in universe \a univIdx
+			double Sigma(std::size_t univIdx, std::size_t knobIdx) const { return fSigmas[knobIdx * fNUniverses + univIdx]; }
+
+			/// Weights of one event in every universe.
+			/// \param wgts  Output: NUniverses() entries
+			void EventWeights(const novarwgt::EventRecord & evt, double * wgts, const novarwgt::InputVals & params = {}) const;
+
+			/// Weights of many events in every universe.
+			/// \param wgts  Output: [event][universe] weights (resized to evts.size() * NUniverses())
+			void Weights(const std::vector<novarwgt::EventRecord> & evts,
+			             std::vector<double> & wgts,
+			             const novarwgt::InputVals & params = {}) const;
+
+			/// Fill one histogram per universe without ever storing all the weights.
+			/// \param var    Quantity to histogram for each event
+			/// \param hists  One histogram per universe
+			void FillHists(const std::vector<novarwgt::EventRecord> & evts,
+			               const std::function<double(const novarwgt::EventRecord &)> & var,
+			               const std::vector<TH1*> & hists,
+			               const novarwgt::InputVals & params = {}) const;
+
+		private:
+			/// Draw the sigmas.  \a chol is the lower-triangular Cholesky factor of the covariance (empty if uncorrelated).
+			void Throw(unsigned int seed, const std::vector<double> & chol);
+
+			const novarwgt::Tune & fTune;
+			std::size_t fNUniverses;
+
+			std::vector<std::string> fKnobNames;
+			std::vector<const novarwgt::ISystKnob*> fKnobs;
+			std::vector<double> fSigmas;    ///< [knob][universe], so each knob's loop over universes is contiguous
+	};
+}
+
+#endif //NOVARWGT_UNIVERSETHROWER_H
@@ -0,0 +1,115 @@
+/*
+ * WeightedSample.h:
+ *  A sample of events whose total weights are kept up to date as knob sigmas change, for use in fits.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_WEIGHTEDSAMPLE_H
+#define NOVARWGT_WEIGHTEDSAMPLE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "NOvARwgt/rwgt/EvalContext.h"
+#include "NOvARwgt/util/InputVals.h"
+
+namespace novarwgt
+{
+	// forward declarations
+	struct EventRecord;
+	class ISystKnob;
+	class Tune;
+
+	/// \brief Events plus their total weights (CV x all of a Tune's knobs) at the current knob sigmas.
+	///
+	/// In a fit, only one or two sigmas usually change between likelihood evaluations.
+	/// Rather than rebuilding every event's weight from all the knobs each time,
+	/// this keeps each knob's factor for each event and the running product,
+	/// and when a knob's sigma changes it only recomputes that knob's factors,
+	/// updating the products by the ratio new/old.
+	/// It also remembers which events each knob can affect at all,
+	/// so a step costs O(events affected by the knob) rather than O(events x knobs).
+	/// That's decided once, at construction, by ISystKnob::CanAffect(): family members by the event's slot,
+	/// other knobs by whether they change the weight at 0, +-1 or +-2 sigma.
+	/// So a knob that is 1 at all of those sigmas for some event is never applied to it,
+	/// even at sigmas where it wouldn't be.
+	///
+	/// Factors that are zero (or not finite) are counted rather than divided by,
+	/// so events whose weight passes through zero come back correctly.
+	/// The running products are rebuilt from the stored factors every so often
+	/// to stop rounding errors from the repeated ratios accumulating.
+	///
+	/// Usage:
+	/// \code
+	///   novarwgt::WeightedSample sample(novarwgt::kCVTune2018, events);
+	///   for (...)   // fit iterations
+	///   {
+	///     sample.SetSigmas(sigmas);   // in the order of sample.KnobNames()
+	///     for (std::size_t evIdx = 0; evIdx < sample.size(); evIdx++)
+	///       ... sample.Weight(evIdx) ...
+	///   }
+	/// \endcode
+	class WeightedSample
+	{
+		public:
+			/// \param tune    The tune providing the CV weight and the knobs
+			/// \param evts    The events.  Not copied, so they must outlive this object (and not change).
+			/// \param params  Any other needed parameters not in the events
+			WeightedSample(const novarwgt::Tune & tune,
+			               const std::vector<novarwgt::EventRecord> & evts,
+			               novarwgt::InputVals params = {});
+
+			/// Number of events
+			std::size_t size() const { return fCVWgts.size(); }
+
+			/// Names of the knobs, in the order they're indexed by here (the same as Tune::KnobNames())
+			const std::vector<std::string> & KnobNames() const { return fKnobNames; }
+
+			/// Change one knob's sigma, updating the weights of the events it affects
+			void SetSigma(std::size_t knobIdx, double sigma);
+
+			/// Change all the sigmas at once (in KnobNames() order).  Only the knobs whose sigma changed cost anything.
+			void SetSigmas(const std::vector<double> & sigmas);
+
+			/// Current sigma for a knob
+			double Sigma(std::size_t knobIdx) const { return fSigmas.at(knobIdx); }
+
+			/// Total weight (CV x all knobs at their current sigmas) for one event
+			double Weight(std::size_t evtIdx) const;
+
+			/// Total weights for all the events.  \a wgts is resized to size().
+			void Weights(std::vector<double> & wgts) const;
+
+			/// Indices of the events whose weight \a knobIdx can change (see ISystKnob::CanAffect())
+			const std::vector<std::size_t> & AffectedEvents(std::size_t knobIdx) const { return fAffected.at(knobIdx); }
+
+		private:
+			/// Apply the factor for one (knob, event) pair, replacing \a oldFactor
+			void UpdateFactor(std::size_t evtIdx, double oldFactor, double newFactor);
+
+			/// Recompute the running products from the stored factors
+			void Rebuild();
+
+			const std::vector<novarwgt::EventRecord> & fEvts;
+			novarwgt::InputVals fParams;
+
+			std::vector<std::string> fKnobNames;
+			std::vector<const novarwgt::ISystKnob*> fKnobs;
+			std::vector<double> fSigmas;
+
+			std::vector<std::vector<std::size_t>> fAffected;   ///< [knob][i]: events each knob can change
+			std::vector<std::vector<double>> fFactors;         ///< [knob][i]: factor for event fAffected[knob][i] at the current sigma
+
+			std::vector<double> fCVWgts;        ///< [event]
+			std::vector<double> fProducts;      ///< [event]: product of the good (nonzero, finite) factors
+			std::vector<unsigned int> fNBad;    ///< [event]: number of zero or non-finite factors
+
+			unsigned int fNUpdates = 0;         ///< SetSigma() calls since the last Rebuild()
+			novarwgt::EvalContext fCtx;
+	};
+}
+
+#endif //NOVARWGT_WEIGHTEDSAMPLE_H
@@ -31,8 +31,12 @@ namespace novarwgt
 
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+			WeightAndDerivative CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+			bool IsAffine() const override { return true; }
 
 		private:
+			double Slope(const novarwgt::EventRecord &ev) const;
+
 			bool fIsNueBar;
 	};
 	extern const SimpleRadiativeCorrNueXSecSyst * kSimpleRadiativeCorrNueXsecSystKnob;
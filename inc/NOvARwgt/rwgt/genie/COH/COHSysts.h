@@ -41,8 +41,12 @@ namespace novarwgt
 
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+			WeightAndDerivative CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+			bool IsAffine() const override { return true; }
 
 		private:
+			double Slope(const novarwgt::EventRecord &ev) const;
+
 			bool fIsCC;
 	};
 	extern const COHNormSyst2018 * kCOHNormCCSystKnob;
@@ -20,8 +20,12 @@ namespace novarwgt
 	//----------------------------------------------------------------------
 	/// Uncertainty on DIS events, configurable by pion multiplicity, neutrino/antineutrino, CC/NC, and hit nucleon.
 	/// These supercede the 1- and 2-pion non-resonant background GENIE tweak parameters.
+	///
+	/// The 32 standard instances (those with the default W parameters) make up a DISnPionSystFamily.
 	class DISnPionSyst : public novarwgt::ISystKnob
 	{
+		friend class DISnPionSystFamily;
+
 		public:
 			template <typename T>
 			explicit DISnPionSyst(const IRegisterable::ClassID<T> & clID,
@@ -31,8 +35,7 @@ namespace novarwgt
 				            std::string("DIS") + (isAntiNu ? "vbar" : "v")
 				                + (struckProton ? "p" : "n") + (isCC ? "CC" : "NC") + std::to_string(nPion) + "pi",
 				            {StoredGenSupportCfg(GenCfg::kGENIE_v2Only)}),
-				  fNPion(nPion), fIsAntiNu(isAntiNu),
-				  fIsCC(isCC), fStruckProton(struckProton),
+				  fSlot(SlotIndex(nPion, isAntiNu, isCC, struckProton)),
 				  fWcut(Wcut), fSystVarLowW(systVarLowW), fSystVarHighW(systVarHighW)
 
 			{
@@ -40,15 +43,54 @@ namespace novarwgt
 			    	throw std::runtime_error("NOvARwgt::DISnPionSyst only supports 0, 1, 2, 3+ pion final states.  You requested " + std::to_string(nPion));
 			}
 
+			/// Number of distinct (pion multiplicity, nu/nubar, CC/NC, struck nucleon) classes
+			static constexpr int kNSlots = 32;
+
+			/// Class index for the given configuration (0 to kNSlots-1), in the order the standard knobs are declared in
+			static int SlotIndex(unsigned int nPion, bool isAntiNu, bool isCC, bool struckProton)
+			{
+				return int(nPion) + 4 * !isCC + 8 * !struckProton + 16 * isAntiNu;
+			}
+
+			/// Class index of the knob that applies to \a ev, or ISystKnobFamily::kNoSlot if none does
+			static int EventSlot(const novarwgt::EventRecord &ev);
+
+			const ISystKnobFamily * Family() const override;
+
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+			WeightAndDerivative CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+			bool IsAffine() const override { return true; }
 
 		private:
-			unsigned int fNPion;
-			bool fIsAntiNu, fIsCC, fStruckProton;
+			double Slope(const novarwgt::EventRecord &ev) const;
+
+			/// Slope for an event already known to be in this knob's class
+			double SlotSlope(const novarwgt::EventRecord &ev) const;
+
+			int fSlot;
 			double fWcut, fSystVarLowW, fSystVarHighW;
 	};
 
+	//----------------------------------------------------------------------
+	/// The 32 standard DISnPionSyst knobs, declared as a unit:
+	/// one classification of the event picks out the only one of them that can affect it.
+	class DISnPionSystFamily : public novarwgt::ISystKnobFamily
+	{
+		public:
+			DISnPionSystFamily();
+
+			int Slot(const novarwgt::EventRecord & ev) const override { return DISnPionSyst::EventSlot(ev); }
+
+			/// The members all support the same generators, so only one of them needs to check
+			void TestIfEvtGenIsSupported(const novarwgt::EventRecord & ev, const novarwgt::InputVals & params = {}) const override;
+
+			double SlotWeight(int slot, double sigma, const novarwgt::EventRecord & ev, const novarwgt::InputVals & params = {}) const override;
+	};
+
+	/// The family of standard DISnPionSyst knobs (built on first use, so it's safe to use during static initialization)
+	const DISnPionSystFamily & GetDISnPionSystFamily();
+
 	extern const DISnPionSyst * kDIS_CC_0pi_nu_p_SystKnob;
 	extern const DISnPionSyst * kDIS_CC_1pi_nu_p_SystKnob;
 	extern const DISnPionSyst * kDIS_CC_2pi_nu_p_SystKnob;
@@ -10,34 +10,132 @@
 #ifndef NOVARWGT_GENIESYSTKNOB_H
 #define NOVARWGT_GENIESYSTKNOB_H
 
+#include <atomic>
+#include <vector>
+
 #include "NOvARwgt/rwgt/ISystKnob.h"
 #include "NOvARwgt/rwgt/genie/GenieKnobNames.h"
 
 namespace novarwgt
 {
+	class WorkerPool;
+	struct StoredWgtDiagnostics;
+
 	class GenieSystKnob : public novarwgt::ISystKnob
 	{
-		friend const GenieSystKnob * GetGenieSystKnob(novarwgt::ReweightKnob knob);
+		public:
+			/// How to get from the stored -2, -1, +1, +2 sigma weights to arbitrary sigma
+			enum Interpolation
+			{
+				kLinearInterp,    ///< straight lines between the points (the traditional behavior)
+				kSplineInterp     ///< monotone cubic spline: smooth first derivative, which helps gradient-based fitters
+			};
+
+		private:
+			friend const GenieSystKnob * GetGenieSystKnob(novarwgt::ReweightKnob knob, Interpolation interp);
+			friend void FillGenieWeightTables(std::vector<novarwgt::EventRecord> & evts,
+			                                  const std::vector<novarwgt::ReweightKnob> & knobs,
+			                                  unsigned int nThreads, Interpolation interp);
+			friend void FillGenieWeightTables(std::vector<novarwgt::EventRecord> & evts,
+			                                  const std::vector<novarwgt::ReweightKnob> & knobs,
+			                                  novarwgt::WorkerPool & pool, Interpolation interp);
 
 		public:
 			/// Make a GENIE syst knob.  You can't use this directly; use GetGenieSystKnob() instead.
 			template <typename T>
-			explicit GenieSystKnob(IRegisterable::ClassID<T> & clID, novarwgt::ReweightKnob knob);
+			explicit GenieSystKnob(IRegisterable::ClassID<T> & clID, novarwgt::ReweightKnob knob, Interpolation interp);
 
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
 
+			/// Exact when stored weights are available (it's just the slope of the interpolation);
+			/// otherwise the numerical derivative from ISystKnob, which costs two more GENIE calculations.
+			WeightAndDerivative CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+
+			/// With stored weights, the table (and for kSplineInterp, its spline) is looked up once for all the sigmas;
+			/// otherwise each sigma is a separate GENIE calculation, as in CalcWeight().
+			void CalcWeights(const double * sigmas, std::size_t n, const novarwgt::EventRecord &ev,
+			                 const novarwgt::InputVals &otherParams, double * wgts) const override;
+
+			/// Compute the -2, -1, +1, +2 sigma weights of this knob for many events at once.
+			///
+			/// Stored weights are used where available.  The remaining events are handed to GENIE
+			/// one sigma value at a time, so that its calculator is only reconfigured four times
+			/// regardless of how many events there are.
+			/// \param evts    Events to compute weights for
+			/// \param tables  Output: one set of weights per event (resized as needed)
+			void CalcWeightTables(const std::vector<const novarwgt::EventRecord*> & evts,
+			                      std::vector<novarwgt::ReweightVals> & tables) const;
+
+			/// Number of stored weights for this knob that were ignored because they were NaN or infinite
+			std::size_t NBadStoredWgts() const { return fNBadStoredWgts; }
+
 		private:
-			double InterpolateStoredWgts(double sigma, const novarwgt::ReweightVals &wgts) const;
+			/// Issue the warning about invoking GENIE, and make sure we're running a GENIE we support
+			void WarnGenieCalc() const;
+
+			/// Throw if this knob can't be computed from a record invented by ToGenieEvent()
+			/// (the hadronization, formation zone, FSI and resonance decay knobs need the real GENIE record)
+			void CheckSyntheticEvtUsable() const;
+
+			/// Implementation of FillGenieWeightTables().  A null \a pool means "use the calling thread".
+			static void FillWeightTables(std::vector<novarwgt::EventRecord> & evts,
+			                             const std::vector<novarwgt::ReweightKnob> & knobs,
+			                             novarwgt::WorkerPool * pool, Interpolation interp);
+
+			/// Interpolate this knob's table in \a rwList (which must be set)
+			/// \param deriv  If supplied, d(weight)/d(sigma) is written to it (0 for bad tables)
+			double InterpolateStoredWgts(double sigma, const novarwgt::ReweightList &rwList, double * deriv = nullptr) const;
+
+			/// Count (and warn about, the first time) interpolated weights that came from bad stored weights
+			void NoteBadStoredWgts(const novarwgt::StoredWgtDiagnostics & diag) const;
 
 			novarwgt::ReweightKnob fKnobIdx;
-			bool fWarnedGenieCalc;             ///< Have we already issued a warning that we're invoking GENIE to calculate weights?
+			Interpolation fInterp;
+			mutable std::atomic<bool> fWarnedGenieCalc;   ///< Have we already issued a warning that we're invoking GENIE to calculate weights?
+			mutable std::atomic<std::size_t> fNBadStoredWgts;
+			mutable std::atomic<bool> fWarnedBadStoredWgt;
 	};
 
 	/// Obtain a knob for a GENIE systematic.
-	inline const GenieSystKnob * GetGenieSystKnob(novarwgt::ReweightKnob knob)
+	/// The spline-interpolated variant of a knob is a separate knob, whose name has "_spline" appended.
+	inline const GenieSystKnob * GetGenieSystKnob(novarwgt::ReweightKnob knob,
+	                                              GenieSystKnob::Interpolation interp = GenieSystKnob::kLinearInterp)
 	{
-		return GetSystKnob<novarwgt::GenieSystKnob>(knob);
+		return GetSystKnob<novarwgt::GenieSystKnob>(knob, interp);
 	}
+
+	/// Precompute the GENIE weight tables (-2, -1, +1, +2 sigma) for \a knobs
+	/// and store them into each event's genieWeights,
+	/// so that later evaluations of those knobs use the (fast) stored weights.
+	/// Tables that are already stored are left alone.
+	///
+	/// The events are divided among \a nThreads threads (0 = one per hardware thread),
+	/// each of which uses its own GENIE calculators.
+	/// The threads come from WorkerPool::Shared(), so they (and their GENIE calculators)
+	/// survive from one call to the next; 1 thread means the calling thread.
+	/// Each event missing any of the tables is converted to a GENIE record just once,
+	/// and GENIE then computes all of the requested knobs for it.
+	///
+	/// If the knobs are going to be used with \a interp = GenieSystKnob::kSplineInterp,
+	/// each event's splines through the tables are precomputed too (see BuildGenieWeightSplines()).
+	void FillGenieWeightTables(std::vector<novarwgt::EventRecord> & evts,
+	                           const std::vector<novarwgt::ReweightKnob> & knobs,
+	                           unsigned int nThreads = 0,
+	                           GenieSystKnob::Interpolation interp = GenieSystKnob::kLinearInterp);
+
+	/// As above, but run on the workers of a caller-supplied \a pool.
+	void FillGenieWeightTables(std::vector<novarwgt::EventRecord> & evts,
+	                           const std::vector<novarwgt::ReweightKnob> & knobs,
+	                           novarwgt::WorkerPool & pool,
+	                           GenieSystKnob::Interpolation interp = GenieSystKnob::kLinearInterp);
+
+	/// Precompute the spline through each of \a knobs' stored weight tables in each event
+	/// (ReweightList::BuildSplines()), so that the kSplineInterp versions of those knobs
+	/// don't have to rebuild it every time they're evaluated.
+	/// Worth doing for events that will be evaluated many times over (in a fit, say)
+	/// whose tables were stored some other way than by FillGenieWeightTables().
+	void BuildGenieWeightSplines(std::vector<novarwgt::EventRecord> & evts,
+	                             const std::vector<novarwgt::ReweightKnob> & knobs);
 } // namespace novarwgt
 
 #endif //NOVARWGT_GENIESYSTKNOB_H
@@ -33,6 +33,8 @@ namespace novarwgt
 		public:
 			explicit MECq0ShapeSyst2017(const IRegisterable::ClassID<MECq0ShapeSyst2017> & clID);
 
+			std::vector<const novarwgt::IWeightGenerator*> Dependencies() const override;
+
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
 
@@ -60,8 +62,12 @@ namespace novarwgt
 
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+			WeightAndDerivative CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+			bool IsAffine() const override { return true; }
 
 		private:
+			double Slope(const novarwgt::EventRecord &ev) const;
+
 			ENuHelicity fHelicity;
 
 			/// this function is the "1 sigma" bound around central value weight 1
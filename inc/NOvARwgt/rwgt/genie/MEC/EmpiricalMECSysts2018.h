@@ -51,6 +51,8 @@ namespace novarwgt
 		          fHelicity(helicity)
 			{}
 
+			std::vector<const novarwgt::IWeightGenerator*> Dependencies() const override;
+
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
 
@@ -11,6 +11,7 @@
 
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "TH2.h"
 
@@ -61,9 +62,14 @@ namespace novarwgt
 			double CalcWeight(const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams) const override
 			{
 				const auto & wgtr = (ev.nupdg > 0) ? fWgtrNu : fWgtrNubar;
-				return wgtr->CalcWeight(ev, otherParams);
+				return wgtr->GetWeight(ev, otherParams);
 			};
 
+			std::vector<const IWeightGenerator*> Dependencies() const override
+			{
+				return {fWgtrNu, fWgtrNubar};
+			}
+
 		private:
 			const EmpiricalMECq0q3TuneWgt * fWgtrNu;
 			const EmpiricalMECq0q3TuneWgt * fWgtrNubar;
@@ -29,6 +29,8 @@ namespace novarwgt
 			template <typename T>
 			explicit MAQEGenieReducedSyst2018(const IRegisterable::ClassID<T> & clID);
 
+			std::vector<const novarwgt::IWeightGenerator*> Dependencies() const override;
+
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
 
@@ -55,6 +57,8 @@ namespace novarwgt
 			template <typename T>
 			explicit MAQEGenieReducedSyst2017(const IRegisterable::ClassID<T> & clID);
 
+			std::vector<const novarwgt::IWeightGenerator*> Dependencies() const override;
+
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
 
@@ -26,6 +26,8 @@ namespace novarwgt
 				: ISystKnob(clID, "RPA", {StoredGenSupportCfg(GenCfg::kGENIE_Prod2Only)})
 			{}
 
+			std::vector<const novarwgt::IWeightGenerator*> Dependencies() const override;
+
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
 	};
@@ -56,6 +58,8 @@ namespace novarwgt
 				  fWgtrDown(wgtDown)
 			{}
 
+			std::vector<const novarwgt::IWeightGenerator*> Dependencies() const override;
+
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
 
@@ -139,10 +143,19 @@ namespace novarwgt
 				  fDoExtrapKludge(extrapKludge)
 			{}
 
+			std::vector<const novarwgt::IWeightGenerator*> Dependencies() const override;
+
 		protected:
 			double CalcWeight(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
+			WeightAndDerivative CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams={}) const override;
 
 		private:
+			/// The sigma actually applied: 0 for negative sigma (the knob is one-sided),
+			/// clamped at 1 above (1.1 beyond 2 sigma with the extrapolation kludge)
+			double EffectiveSigma(double sigma) const;
+
+			double Slope(const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams) const;
+
 			const novarwgt::IWeightGenerator * fWgtr;
 			bool fSystIsEnableEffect;
 			bool fDoExtrapKludge;
@@ -9,6 +9,7 @@
 #ifndef NOVARWGT_RPAWEIGHTS_H
 #define NOVARWGT_RPAWEIGHTS_H
 
+#include <atomic>
 #include <string>
 
 #include "TH1.h"
@@ -76,8 +77,10 @@ namespace novarwgt
 			const novarwgt::HistWrapper <TH2> fHist_nu;
 			const novarwgt::HistWrapper <TH2> fHist_nubar;
 
-			mutable int fq0MinBin_nu;     ///< older (SA) RPA histograms have a minimum q0 below which the histogram is empty.  cache to speed things up
-			mutable int fq0MinBin_nubar;  ///< older (SA) RPA histograms have a minimum q0 below which the histogram is empty.  cache to speed things up
+			/// older (SA) RPA histograms have a minimum q0 below which the histogram is empty.  cache to speed things up.
+			/// (atomic since it's filled on first use, possibly from several threads.  they all compute the same value.)
+			mutable std::atomic<int> fq0MinBin_nu;
+			mutable std::atomic<int> fq0MinBin_nubar;  ///< see fq0MinBin_nu
 
 			bool fForceNu;                 ///< reproduce old buggy behavior where the neutrino correction was used for antinus?
 	};
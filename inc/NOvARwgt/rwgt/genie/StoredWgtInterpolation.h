@@ -0,0 +1,127 @@
+/*
+ * StoredWgtInterpolation.h:
+ *  Interpolation of stored GENIE weight tables (-2, -1, +1, +2 sigma) to arbitrary sigma.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_STOREDWGTINTERPOLATION_H
+#define NOVARWGT_STOREDWGTINTERPOLATION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "NOvARwgt/rwgt/EventRecord.h"
+#include "NOvARwgt/rwgt/genie/StoredWgtSpline.h"
+
+namespace novarwgt
+{
+	/// Counts of interpolated weights that couldn't be used because the table entries they came from were bad.
+	/// (Such weights are replaced by 1.)
+	struct StoredWgtDiagnostics
+	{
+		std::size_t nNaN = 0;
+		std::size_t nInf = 0;
+	};
+
+	/// Linear interpolation between the (-2, -1, 0, +1, +2) sigma points of a ReweightVals table
+	/// (where the 0 sigma weight is 1) only depends on sigma through the coefficients of the combination
+	///
+	///    weight = one + m2 * minus2sigma + m1 * minus1sigma + p1 * plus1sigma + p2 * plus2sigma
+	///
+	/// so they can be computed once per sigma and then applied to any number of tables.
+	/// At most two of the coefficients are ever nonzero.
+	/// Beyond +-2 sigma the outermost segment is extrapolated.
+	struct StoredWgtCoeffs
+	{
+		double one = 1;
+		double m2  = 0;
+		double m1  = 0;
+		double p1  = 0;
+		double p2  = 0;
+
+		static StoredWgtCoeffs ForSigma(double sigma);
+
+		/// Coefficients giving d(weight)/d(sigma) instead of the weight.
+		/// (At a node, the slope of the segment above it is used.)
+		static StoredWgtCoeffs DerivativeForSigma(double sigma);
+
+		/// The combination above, with entries whose coefficient is zero masked out
+		double Apply(const novarwgt::ReweightVals & vals) const
+		{
+			return one
+			       + (m2 != 0 ? m2 * vals.minus2sigma : 0.)
+			       + (m1 != 0 ? m1 * vals.minus1sigma : 0.)
+			       + (p1 != 0 ? p1 * vals.plus1sigma  : 0.)
+			       + (p2 != 0 ? p2 * vals.plus2sigma  : 0.);
+		}
+	};
+
+	/// Apply the coefficients to one table.
+	/// Entries whose coefficient is zero are masked out (so e.g. a NaN +2 sigma entry doesn't matter at sigma = 0.5).
+	/// A weight that still comes out NaN or infinite is counted in \a diag and replaced by 1.
+	inline double InterpolateStoredWgt(const StoredWgtCoeffs & coeffs, const novarwgt::ReweightVals & vals, StoredWgtDiagnostics & diag)
+	{
+		const double wgt = coeffs.Apply(vals);
+		const bool isNaN = std::isnan(wgt);
+		const bool isInf = std::isinf(wgt);
+		diag.nNaN += isNaN;
+		diag.nInf += isInf;
+		return (isNaN || isInf) ? 1. : wgt;
+	}
+
+	/// Interpolate a whole dense table of stored weights at once.
+	///
+	/// The table is plain floats, laid out [event][knob][4] with the 4 entries in ReweightVals order
+	/// (-2, -1, +1, +2 sigma).  The per-knob coefficients are computed up front and then applied
+	/// to every entry unconditionally; entries that shouldn't contribute (zero coefficient)
+	/// and bad ones (NaN or infinite) are zeroed with bit masks and the bad weights replaced by 1 with
+	/// an arithmetic blend, so the loop over knobs has no branches and the compiler vectorizes it.
+	/// A weight counts as NaN in \a diag if any entry it uses is NaN, otherwise as infinite if any is infinite.
+	///
+	/// \param tables  [event][knob][4] stored weights (nEvts * nKnobs * 4 floats)
+	/// \param nEvts   Number of events
+	/// \param nKnobs  Number of knobs
+	/// \param sigmas  Sigma to evaluate each knob at (nKnobs entries)
+	/// \param wgts    Output: [event][knob] weights (nEvts * nKnobs entries)
+	/// \param diag    If supplied, the counts of bad weights are added to it
+	void InterpolateStoredWgts(const float * tables,
+	                           std::size_t nEvts,
+	                           std::size_t nKnobs,
+	                           const double * sigmas,
+	                           double * wgts,
+	                           StoredWgtDiagnostics * diag = nullptr);
+
+	/// Same as above, for a table of ReweightVals (which is the same [event][knob][4] floats in memory)
+	void InterpolateStoredWgts(const novarwgt::ReweightVals * tables,
+	                           std::size_t nEvts,
+	                           std::size_t nKnobs,
+	                           const double * sigmas,
+	                           double * wgts,
+	                           StoredWgtDiagnostics * diag = nullptr);
+
+	/// Number of floats BuildStoredWgtSplines() writes per table: [segment][power of t]
+	constexpr std::size_t kStoredWgtSplineSize = 16;
+
+	/// Precompute the spline coefficients for \a n tables (e.g. a whole [event][knob] table)
+	/// into \a coeffs, kStoredWgtSplineSize floats per table (the StoredWgtSpline::coeffs of each).
+	/// A spline built from a bad table is stored with its constant terms set to NaN (or infinity,
+	/// matching the bad entry) and everything else 0, which InterpolateStoredWgtSplines() recognizes.
+	void BuildStoredWgtSplines(const novarwgt::ReweightVals * tables, std::size_t n, float * coeffs);
+
+	/// Same as InterpolateStoredWgts(), but using precomputed splines (from BuildStoredWgtSplines()),
+	/// laid out [event][knob][kStoredWgtSplineSize].
+	/// Each knob's segment and offset are found once; the per-event work is then the same
+	/// masked, branch-free multiply-add as for the linear interpolation.
+	/// Splines built from bad tables give weight 1 and are counted in \a diag.
+	void InterpolateStoredWgtSplines(const float * splineCoeffs,
+	                                 std::size_t nEvts,
+	                                 std::size_t nKnobs,
+	                                 const double * sigmas,
+	                                 double * wgts,
+	                                 StoredWgtDiagnostics * diag = nullptr);
+}
+
+#endif //NOVARWGT_STOREDWGTINTERPOLATION_H
@@ -0,0 +1,103 @@
+/*
+ * StoredWgtSpline.h:
+ *  Monotone cubic spline through a stored GENIE weight table (-2, -1, +1, +2 sigma).
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_STOREDWGTSPLINE_H
+#define NOVARWGT_STOREDWGTSPLINE_H
+
+#include <algorithm>
+#include <cmath>
+
+// kept apart from StoredWgtInterpolation.h, since EventRecord.cxx needs it (to cache splines in ReweightList)
+namespace novarwgt
+{
+	struct ReweightVals;
+
+	/// Smooth alternative to the linear interpolation:
+	/// a monotone piecewise-cubic (Fritsch-Carlson) curve through the (-2, -1, 0, +1, +2) sigma points,
+	/// whose first derivative is continuous everywhere (including at the nodes),
+	/// and which doesn't overshoot the stored points the way an ordinary cubic spline can.
+	/// Beyond +-2 sigma it continues linearly with the end slope.
+	///
+	/// The coefficients are computed once (in the constructor), after which each evaluation
+	/// is a segment lookup and a cubic, so it costs about the same as the linear interpolation.
+	struct StoredWgtSpline
+	{
+		StoredWgtSpline() = default;
+		explicit StoredWgtSpline(const novarwgt::ReweightVals & vals);
+
+		/// False if any of the stored weights was NaN or infinite, in which case Eval() always returns 1
+		bool IsValid() const { return !hasNaN && !hasInf; }
+
+		/// Split sigma into segment index and offset within it.
+		/// \param extrap  -1 (0, +1) if sigma is below (within, above) the range of the nodes
+		static void Locate(double sigma, unsigned int & seg, double & t, int & extrap)
+		{
+			extrap = (sigma < -2) ? -1 : (sigma >= 2 ? +1 : 0);
+			const double clamped = std::min(std::max(sigma, -2.), 2.);
+			seg = std::min(unsigned(std::floor(clamped) + 2), 3u);
+			t = sigma - (double(seg) - 2);
+		}
+
+		/// Evaluate at a location found with Locate()
+		double Eval(unsigned int seg, double t, int extrap) const
+		{
+			if (!IsValid())
+				return 1.;
+
+			const float * c = coeffs[seg];
+			if (extrap < 0)
+				return c[0] + c[1] * t;
+			else if (extrap > 0)
+				return (c[0] + c[1] + c[2] + c[3]) + (c[1] + 2*c[2] + 3*c[3]) * (t - 1);
+			return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+		}
+
+		double Eval(double sigma) const
+		{
+			unsigned int seg;
+			double t;
+			int extrap;
+			Locate(sigma, seg, t, extrap);
+			return Eval(seg, t, extrap);
+		}
+
+		/// d(weight)/d(sigma) at a location found with Locate().  0 if !IsValid().
+		double Derivative(unsigned int seg, double t, int extrap) const
+		{
+			if (!IsValid())
+				return 0.;
+
+			const float * c = coeffs[seg];
+			if (extrap < 0)
+				return c[1];
+			else if (extrap > 0)
+				return c[1] + 2*c[2] + 3*c[3];
+			return c[1] + t * (2*c[2] + t * 3*c[3]);
+		}
+
+		double Derivative(double sigma) const
+		{
+			unsigned int seg;
+			double t;
+			int extrap;
+			Locate(sigma, seg, t, extrap);
+			return Derivative(seg, t, extrap);
+		}
+
+		/// Was this spline made from exactly these stored weights?
+		/// (Bitwise comparison, so a table containing NaNs still matches itself.)
+		bool BuiltFrom(const novarwgt::ReweightVals & vals) const;
+
+		float coeffs[4][4] = {};   ///< [segment][power of t] for segment k covering sigma in [k-2, k-1]
+		float source[4] = {};      ///< the stored weights it was built from (-2, -1, +1, +2 sigma)
+		bool hasNaN = false;
+		bool hasInf = false;
+	};
+}
+
+#endif //NOVARWGT_STOREDWGTSPLINE_H
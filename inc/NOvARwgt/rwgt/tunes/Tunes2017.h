@@ -9,20 +9,29 @@
 #ifndef NOVARWGT_TUNES2017_H
 #define NOVARWGT_TUNES2017_H
 
-#include <unordered_set>
+#include "NOvARwgt/rwgt/StaticTune.h"
 #include "NOvARwgt/rwgt/Tune.h"
 #include "NOvARwgt/rwgt/ISystKnob.h"
 
+#include "NOvARwgt/rwgt/genie/QE/RPAWeights.h"
+#include "NOvARwgt/rwgt/genie/MEC/EmpiricalMECTune2017.h"
+#include "NOvARwgt/rwgt/genie/DIS/Nonres1piWeights.h"
+
 namespace novarwgt
 {
 	/// Knobs from GENIE ReWeight included in the 2017 error budget
-	extern const std::unordered_set<const novarwgt::ISystKnob*> k2017GENIEKnobs;
+	extern const novarwgt::SystKnobSet k2017GENIEKnobs;
 
 	/// NOvA custom knobs included in the 2017 error budget
-	extern const std::unordered_set<const novarwgt::ISystKnob*> k2017CustomKnobs;
+	extern const novarwgt::SystKnobSet k2017CustomKnobs;
 
 	/// CV MC tune used in 2017 analyses
 	extern const novarwgt::Tune kCVTune2017;
+
+	typedef novarwgt::StaticTune<RPAWeightCCQE_2017, Nonres1PiWgt, EmpiricalMECWgt2017>  StaticCVTune2017_t;
+
+	/// Static version of kCVTune2017 (same weighters, but no virtual calls)
+	extern const StaticCVTune2017_t kStaticCVTune2017;
 }
 
 #endif //NOVARWGT_TUNES2017_H
@@ -10,19 +10,26 @@
 #define NOVARWGT_TUNES2018_H
 
 
+#include "NOvARwgt/rwgt/StaticTune.h"
 #include "NOvARwgt/rwgt/Tune.h"
 
+#include "NOvARwgt/rwgt/genie/QE/MAQEWgts.h"
+#include "NOvARwgt/rwgt/genie/QE/RPAWeights.h"
+#include "NOvARwgt/rwgt/genie/MEC/EmpiricalMECTune2018.h"
+#include "NOvARwgt/rwgt/genie/DIS/Nonres1piWeights.h"
+#include "NOvARwgt/rwgt/genie/DIS/HighWDISWeight.h"
+
 namespace novarwgt
 {
 	/// GENIE ReWeight knobs used in the 2018 error budget
-	extern const std::unordered_set<const novarwgt::ISystKnob*> k2018GENIEKnobs;
+	extern const novarwgt::SystKnobSet k2018GENIEKnobs;
 
 	/// Original set of MEC knobs used in the 2018 oscillation analysis
-	extern const std::unordered_set<const novarwgt::ISystKnob*> k2018MECKnobs;
+	extern const novarwgt::SystKnobSet k2018MECKnobs;
 
 	/// Set of MEC knobs tuned using the correct implementation of the RPA knobs
 	/// (i.e., not mistakenly applying RPA to Hydrogen in the QE part of the base model)
-	extern const std::unordered_set<const novarwgt::ISystKnob*> k2018MECKnobs_RPAFix;
+	extern const novarwgt::SystKnobSet k2018MECKnobs_RPAFix;
 
 	/// CV tune used for 2018 analysis
 	extern const novarwgt::Tune kCVTune2018;
@@ -34,6 +41,25 @@ namespace novarwgt
 	/// 2018 cross section weight updated after Hydrogen RPA bug fix but without DIS tweak
 	/// (and without correction to actual GENIE 2.12 RPA-CCQE weights)
 	extern const novarwgt::Tune kCVTune2018_RPAfix_noDIStweak;
+
+	// ------------------------------------------------------------------------------------
+	// the same CV weights in StaticTune form (same weighters, but no virtual calls)
+
+	typedef novarwgt::StaticTune<MAQEWeight_2018, RPAWeightCCQE_2017, RPAWeightQ2_2017,
+	                             Nonres1PiWgt, HighWDISWgt_2018, EmpiricalMECWgt2018>        StaticCVTune2018_t;
+	typedef novarwgt::StaticTune<MAQEWeight_2018, RPAWeightCCQE_2017, RPAWeightQ2_2017,
+	                             Nonres1PiWgt, HighWDISWgt_2018, EmpiricalMECWgt2018RPAFix>  StaticCVTune2018_RPAfix_t;
+	typedef novarwgt::StaticTune<MAQEWeight_2018, RPAWeightCCQE_2017, RPAWeightQ2_2017,
+	                             Nonres1PiWgt, EmpiricalMECWgt2018RPAFix>                    StaticCVTune2018_RPAfix_noDIStweak_t;
+
+	/// Static version of kCVTune2018
+	extern const StaticCVTune2018_t kStaticCVTune2018;
+
+	/// Static version of kCVTune2018_RPAfix
+	extern const StaticCVTune2018_RPAfix_t kStaticCVTune2018_RPAfix;
+
+	/// Static version of kCVTune2018_RPAfix_noDIStweak
+	extern const StaticCVTune2018_RPAfix_noDIStweak_t kStaticCVTune2018_RPAfix_noDIStweak;
 }
 
 #endif //NOVARWGT_TUNES2018_H
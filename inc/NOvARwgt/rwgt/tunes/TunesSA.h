@@ -9,13 +9,22 @@
 #ifndef NOVARWGT_TUNESSA_H
 #define NOVARWGT_TUNESSA_H
 
+#include "NOvARwgt/rwgt/StaticTune.h"
 #include "NOvARwgt/rwgt/Tune.h"
 
+#include "NOvARwgt/rwgt/genie/DIS/Nonres1piWeights.h"
+#include "NOvARwgt/rwgt/genie/MEC/EmpiricalMECTuneSA.h"
+
 namespace novarwgt
 {
 	/// CV MC tune used in Second Analysis
 	extern const novarwgt::Tune kCVTuneSA;
 
+	typedef novarwgt::StaticTune<Nonres1PiWgt, Tufts2p2hWgtSA>  StaticCVTuneSA_t;
+
+	/// Static version of kCVTuneSA (same weighters, but no virtual calls)
+	extern const StaticCVTuneSA_t kStaticCVTuneSA;
+
 }
 
 #endif //NOVARWGT_TUNESSA_H
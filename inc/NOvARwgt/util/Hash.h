@@ -9,6 +9,7 @@
 #ifndef NOVARWGT_HASH_H
 #define NOVARWGT_HASH_H
 
+#include <cstdint>
 #include <functional>
 
 namespace novarwgt
@@ -21,12 +22,26 @@ namespace novarwgt
 			return seed;
 		}
 
+		/// Scramble the bits of a hash value (the splitmix64 finalizer).
+		/// std::hash<> of integers and enums is usually just the value itself, which the combination below
+		/// doesn't mix well enough on its own: e.g. (71, 0) and (6, 1) came out the same.
+		inline std::size_t Mix(std::size_t h)
+		{
+			std::uint64_t x = h;
+			x ^= x >> 30;
+			x *= 0xbf58476d1ce4e5b9ULL;
+			x ^= x >> 27;
+			x *= 0x94d049bb133111ebULL;
+			x ^= x >> 31;
+			return std::size_t(x);
+		}
+
 		/// Used for the hashing inside the weighter registry.
 		/// magic values & idea adapted from here: https://stackoverflow.com/questions/23859844/hash-function-for-a-vector-of-pairint-int
 		template <typename T>
 		std::size_t Hash(const T& v, std::size_t seed)
 		{
-			seed ^= std::hash<T>{}(v) + 0x9e3779b9 + (seed<<6) + (seed>>2);
+			seed ^= Mix(std::hash<T>{}(v)) + 0x9e3779b9 + (seed<<6) + (seed>>2);
 			return seed;
 		}
 
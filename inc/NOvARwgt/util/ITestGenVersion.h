@@ -35,13 +35,20 @@ namespace novarwgt
 					ThrowUnsupportedException(gen, genVersion, genConfigStr);
 			}
 
-			void TestIfEvtGenIsSupported(const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams) const
+			/// Like TestIfEvtGenIsSupported(), but just says so instead of throwing
+			bool EvtGenIsSupported(const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams) const
 			{
-				bool supported = false;
 				for (const auto & genSupport : fGeneratorSupport)
-					supported = supported || genSupport.EventIsSupported(ev, otherParams);
+				{
+					if (genSupport.EventIsSupported(ev, otherParams))
+						return true;
+				}
+				return false;
+			}
 
-				if (!supported)
+			void TestIfEvtGenIsSupported(const novarwgt::EventRecord &ev, const novarwgt::InputVals &otherParams) const
+			{
+				if (!EvtGenIsSupported(ev, otherParams))
 					ThrowUnsupportedException(ev.generator, ev.generatorVersion, ev.generatorConfigStr);
 			}
 
@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <exception>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "TFile.h"
@@ -25,6 +26,7 @@ namespace novarwgt
 
   /// Container that loads objects from ROOT file lazily (i.e., on access)
   /// Could be used for any type that a ROOT file contains, though primary usage is for histograms.
+  /// The load happens exactly once even if the first accesses come from several threads at once.
   template <typename ObjType>
   class LazyROOTObjLoader
   {
@@ -43,6 +45,7 @@ namespace novarwgt
 
     private:
       void _LoadObj() const;
+      mutable std::once_flag fLoadFlag;
       mutable std::unique_ptr<ObjType> fObj;
 
       std::string fFilename;
@@ -55,26 +58,20 @@ namespace novarwgt
   template <typename ObjType>
   typename std::add_lvalue_reference<ObjType>::type LazyROOTObjLoader<ObjType>::operator*() const
   {
-    if (!fObj)
-      _LoadObj();
-
-    return *(fObj);
+    return *(get());
   }
 
   template <typename ObjType>
   ObjType * LazyROOTObjLoader<ObjType>::operator->() const
   {
-    if (!fObj)
-      _LoadObj();
-
-    return fObj.get();
+    return get();
   }
 
   template <typename ObjType>
   ObjType * LazyROOTObjLoader<ObjType>::get() const
   {
-    if (!fObj)
-      _LoadObj();
+    // if _LoadObj() throws, the flag isn't set, and the next call tries again
+    std::call_once(fLoadFlag, [this]() { _LoadObj(); });
 
     return fObj.get();
   }
@@ -0,0 +1,76 @@
+/*
+ * WorkerPool.h:
+ *  Persistent worker threads for the library's parallel loops.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#ifndef NOVARWGT_WORKERPOOL_H
+#define NOVARWGT_WORKERPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace novarwgt
+{
+	/// A fixed set of worker threads that live as long as the pool does.
+	///
+	/// Much of the expensive state in NOvARwgt is kept per thread
+	/// (the GENIE calculator pool, the CC-QE cross section model, the synthetic GENIE record, ...).
+	/// Spawning fresh threads for every call would throw all of it away each time;
+	/// workers in a pool keep theirs from one Run() to the next.
+	///
+	/// Only one Run() executes at a time per pool; concurrent callers wait their turn.
+	/// A Run() issued from inside one of the pool's own tasks executes serially on that thread
+	/// (rather than deadlocking waiting for itself).
+	class WorkerPool
+	{
+		public:
+			/// \param nThreads  Number of workers (0 = one per hardware thread)
+			explicit WorkerPool(unsigned int nThreads = 0);
+			~WorkerPool();
+
+			WorkerPool(const WorkerPool &) = delete;
+			WorkerPool & operator=(const WorkerPool &) = delete;
+
+			unsigned int NThreads() const { return unsigned(fWorkers.size()); }
+
+			/// Call task(idx) for every idx in [0, nTasks), spread over the workers,
+			/// and return once all of them are done.
+			/// Which worker gets which task is not fixed, so tasks must not depend on it.
+			/// If any task throws, the exception from the lowest-numbered failing task is rethrown
+			/// (after all tasks have finished).
+			void Run(std::size_t nTasks, const std::function<void(std::size_t)> & task);
+
+			/// A process-wide pool with \a nThreads workers (0 = one per hardware thread),
+			/// made the first time it's asked for.
+			static WorkerPool & Shared(unsigned int nThreads = 0);
+
+		private:
+			void WorkerLoop();
+
+			std::vector<std::thread> fWorkers;
+
+			std::mutex fRunMutex;    ///< serializes Run() calls
+
+			std::mutex fMutex;       ///< protects everything below
+			std::condition_variable fWakeWorkers;
+			std::condition_variable fJobDone;
+			const std::function<void(std::size_t)> * fTask = nullptr;
+			std::size_t fNTasks = 0;
+			std::size_t fNextTask = 0;
+			std::size_t fNFinished = 0;
+			std::size_t fJobSerial = 0;
+			bool fStopping = false;
+			std::size_t fErrorIdx = 0;
+			std::exception_ptr fError;
+	};
+}
+
+#endif //NOVARWGT_WORKERPOOL_H
@@ -10,6 +10,8 @@
 
 #include <memory>
 #include <regex>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
 
 
@@ -36,17 +38,76 @@
 
 namespace novarwgt
 {
-	// todo: need to decide how to specify which weights should be calculated on-the-fly if they're not pre-stored
-	novarwgt::EventRecord ConvertGenieEvent(const genie::EventRecord *evt,
-	                                        const ReweightList &storedWgts)
+	// --------------------------------------
+	// assume that the version of GENIE used to read the event was also the one used to make it.
+	// not foolproof, but best we can do here.
+	GenieEventConverter::GenieEventConverter()
+		: fGeneratorVersion(novarwgt::internal::GetGENIEVersion()),
+		  fGeneratorConfig(novarwgt::internal::GetGENIETune())
+	{}
+
+	// --------------------------------------
+	void GenieEventConverter::Convert(const genie::EventRecord *evt, novarwgt::EventRecord &rec) const
+	{
+		FillRecord(evt, rec);
+		rec.genieWeights.clear();
+	}
+
+	// --------------------------------------
+	void GenieEventConverter::Convert(const genie::EventRecord *evt,
+	                                  novarwgt::EventRecord &rec,
+	                                  const novarwgt::ReweightList &storedWgts) const
+	{
+		FillRecord(evt, rec);
+		rec.genieWeights = storedWgts;   // copy-assignment reuses the existing storage
+	}
+
+	// --------------------------------------
+	novarwgt::EventRecord GenieEventConverter::Convert(const genie::EventRecord *evt) const
+	{
+		novarwgt::EventRecord rec;
+		FillRecord(evt, rec);
+		return rec;
+	}
+
+	// --------------------------------------
+	novarwgt::EventRecord GenieEventConverter::Convert(const genie::EventRecord *evt,
+	                                                   const novarwgt::ReweightList &storedWgts) const
 	{
 		novarwgt::EventRecord rec;
+		Convert(evt, rec, storedWgts);
+		return rec;
+	}
 
-		// assume that the version of GENIE used to read the event was also the one used to make it.
-		// not foolproof, but best we can do here.
+	// --------------------------------------
+	void GenieEventConverter::Convert(const std::vector<const genie::EventRecord *> &evts,
+	                                  std::vector<novarwgt::EventRecord> &out) const
+	{
+		out.resize(evts.size());
+		for (std::size_t idx = 0; idx < evts.size(); idx++)
+			Convert(evts[idx], out[idx]);
+	}
+
+	// --------------------------------------
+	void GenieEventConverter::Convert(const std::vector<const genie::EventRecord *> &evts,
+	                                  const std::vector<novarwgt::ReweightList> &storedWgts,
+	                                  std::vector<novarwgt::EventRecord> &out) const
+	{
+		if (storedWgts.size() != evts.size())
+			throw std::runtime_error("NOvARwgt: GenieEventConverter::Convert(): got " + std::to_string(evts.size())
+			                         + " events but " + std::to_string(storedWgts.size()) + " weight lists");
+
+		out.resize(evts.size());
+		for (std::size_t idx = 0; idx < evts.size(); idx++)
+			Convert(evts[idx], out[idx], storedWgts[idx]);
+	}
+
+	// --------------------------------------
+	void GenieEventConverter::FillRecord(const genie::EventRecord *evt, novarwgt::EventRecord &rec) const
+	{
 		rec.generator = kGENIE;
-		rec.generatorVersion = novarwgt::internal::GetGENIEVersion();
-		rec.generatorConfigStr = novarwgt::internal::GetGENIETune();
+		rec.generatorVersion = fGeneratorVersion;   // vector & string assignment reuse existing capacity
+		rec.generatorConfigStr = fGeneratorConfig;
 
 		// BEWARE: there are two ways to calculate many of the values below:
 		//  (1) using the 'selected' kinematics,
@@ -95,11 +156,19 @@ namespace novarwgt
 		rec.npizero = evt->NEntries(111, genie::kIStHadronInTheNucleus);
 		rec.npiminus = evt->NEntries(-211, genie::kIStHadronInTheNucleus);
 
-		rec.genieWeights = storedWgts;
+		rec.expectNoWeights = false;
 
 		rec.origGenieEvt = evt;
 
-		return rec;
+		rec.Finalize();
+	}
+
+	//----------------------------------------------------------------------------
+	// todo: need to decide how to specify which weights should be calculated on-the-fly if they're not pre-stored
+	novarwgt::EventRecord ConvertGenieEvent(const genie::EventRecord *evt,
+	                                        const ReweightList &storedWgts)
+	{
+		return GenieEventConverter().Convert(evt, storedWgts);
 	}
 
 }
@@ -7,12 +7,16 @@
  */
 
 
+#include <iostream>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
 
 #include "nusimdata/SimulationBase/GTruth.h"
 #include "nusimdata/SimulationBase/MCGeneratorInfo.h"
 #include "nusimdata/SimulationBase/MCTruth.h"
 
+#include "NOvARwgt/interfaces/NuToolsInterface.h"
 #include "NOvARwgt/rwgt/EventRecord.h"
 #include "NOvARwgt/util/GeneratorSupportConfig.h"
 
@@ -37,33 +41,44 @@ namespace novarwgt
 	}
 
 
-	novarwgt::EventRecord ConvertNuToolsEvent(const simb::MCTruth * mctruth, const simb::GTruth * gtruth, const novarwgt::ReweightList & rwList)
+	// --------------------------------------
+	void NuToolsEventConverter::UpdateGeneratorContext(const simb::MCGeneratorInfo & genInfo)
 	{
-		novarwgt::EventRecord rec;
-
-		// this is very rudimentary caching
-		rec.generator = DecodeGenerator(mctruth->GeneratorInfo().generator);
-		static std::string oldVersionStr = std::string{};
-		static std::vector<int> oldVersionVec = std::vector<int>{};
-		static std::unordered_map<std::string, std::string> oldGenConfig = std::unordered_map<std::string, std::string>{};
-		static std::string oldGenConfigStr = std::string{};
-		if (mctruth->GeneratorInfo().generatorVersion != oldVersionStr || mctruth->GeneratorInfo().generatorConfig != oldGenConfig)
+		// comparing against the stored copy doesn't allocate, and unlike a hash it can't be fooled by a collision.
+		// (unordered_map's operator== doesn't depend on iteration order.)
+		if (fHaveContext
+		    && int(genInfo.generator) == fGenInfoGenerator
+		    && genInfo.generatorVersion == fGenInfoVersion
+		    && genInfo.generatorConfig == fGenInfoConfig)
+			return;
+
+		fHaveContext = true;
+		fGenInfoGenerator = int(genInfo.generator);
+		fGenInfoVersion = genInfo.generatorVersion;
+		fGenInfoConfig = genInfo.generatorConfig;
+
+		fGenerator = DecodeGenerator(genInfo.generator);
+		fGeneratorVersion = DecodeGeneratorVersion(genInfo.generatorVersion);
+		fGeneratorConfigStr.clear();
+		for (const auto & configPair: genInfo.generatorConfig)
 		{
-			oldVersionStr = mctruth->GeneratorInfo().generatorVersion;
-			oldVersionVec = DecodeGeneratorVersion(mctruth->GeneratorInfo().generatorVersion);
-			oldGenConfig = mctruth->GeneratorInfo().generatorConfig;
-			oldGenConfigStr = "";
-			for (const auto & configPair: oldGenConfig)
-			{
-				if (configPair.first == "tune")
-					oldGenConfigStr = configPair.second;
-				else
-					std::cerr << "Don't know how to store generator config parameter named '" << configPair.first << "'";
-			}
+			if (configPair.first == "tune")
+				fGeneratorConfigStr = configPair.second;
+			else if (fWarnedConfigKeys.insert(configPair.first).second)
+				std::cerr << "Don't know how to store generator config parameter named '" << configPair.first << "'" << std::endl;
 		}
-		rec.generatorVersion = oldVersionVec;
-		if (!oldGenConfigStr.empty())
-			rec.generatorConfigStr = oldGenConfigStr;
+	}
+
+	// --------------------------------------
+	void NuToolsEventConverter::Convert(const simb::MCTruth * mctruth,
+	                                    const simb::GTruth * gtruth,
+	                                    const novarwgt::ReweightList & rwList,
+	                                    novarwgt::EventRecord & rec)
+	{
+		UpdateGeneratorContext(mctruth->GeneratorInfo());
+		rec.generator = fGenerator;
+		rec.generatorVersion = fGeneratorVersion;   // vector & string assignment reuse existing capacity
+		rec.generatorConfigStr = fGeneratorConfigStr;
 
 		const auto & nu = mctruth->GetNeutrino();
 		rec.nupdg      = nu.Nu().PdgCode();
@@ -85,8 +100,44 @@ namespace novarwgt
 
 		rec.genieWeights = rwList;
 
+		rec.expectNoWeights = false;
+		rec.origGenieEvt = nullptr;
+
+		rec.Finalize();
+	}
+
+	// --------------------------------------
+	novarwgt::EventRecord NuToolsEventConverter::Convert(const simb::MCTruth * mctruth,
+	                                                     const simb::GTruth * gtruth,
+	                                                     const novarwgt::ReweightList & rwList)
+	{
+		novarwgt::EventRecord rec;
+		Convert(mctruth, gtruth, rwList, rec);
 		return rec;
+	}
 
+	// --------------------------------------
+	void NuToolsEventConverter::Convert(const std::vector<simb::MCTruth> & mctruths,
+	                                    const std::vector<simb::GTruth> & gtruths,
+	                                    const std::vector<novarwgt::ReweightList> & rwLists,
+	                                    std::vector<novarwgt::EventRecord> & out)
+	{
+		if (gtruths.size() != mctruths.size() || (!rwLists.empty() && rwLists.size() != mctruths.size()))
+			throw std::runtime_error("NOvARwgt: NuToolsEventConverter::Convert(): got " + std::to_string(mctruths.size())
+			                         + " MCTruths, " + std::to_string(gtruths.size()) + " GTruths, and "
+			                         + std::to_string(rwLists.size()) + " weight lists");
+
+		out.resize(mctruths.size());
+		const novarwgt::ReweightList noWgts;
+		for (std::size_t idx = 0; idx < mctruths.size(); idx++)
+			Convert(&mctruths[idx], &gtruths[idx], rwLists.empty() ? noWgts : rwLists[idx], out[idx]);
+	}
+
+	// --------------------------------------
+	novarwgt::EventRecord ConvertNuToolsEvent(const simb::MCTruth * mctruth, const simb::GTruth * gtruth, const novarwgt::ReweightList & rwList)
+	{
+		thread_local NuToolsEventConverter converter;
+		return converter.Convert(mctruth, gtruth, rwList);
 	}
 
 }
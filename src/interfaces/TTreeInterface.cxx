@@ -0,0 +1,290 @@
+/*
+ * TTreeInterface.cxx:
+ *  Interface to flat ROOT ntuples of truth information.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "Bytes.h"
+#include "RVersion.h"
+#include "TBranch.h"
+#include "TBufferFile.h"
+#include "TLeaf.h"
+#include "TMath.h"
+#include "TObjArray.h"
+#include "TTree.h"
+
+#include "NOvARwgt/interfaces/TTreeInterface.h"
+#include "NOvARwgt/rwgt/EventBatch.h"
+
+namespace novarwgt
+{
+	// anonymous namespace since it shouldn't be in the interface
+	namespace
+	{
+		/// Deserialize \a n values of type Leaf_t (skipping the first \a skip) from a bulk-read buffer
+		template <typename Leaf_t, typename T>
+		void Unpack(char * buf, std::size_t skip, std::size_t n, T * out)
+		{
+			buf += skip * sizeof(Leaf_t);
+			for (std::size_t idx = 0; idx < n; idx++)
+			{
+				Leaf_t val;
+				frombuf(buf, &val);   // also advances buf
+				out[idx] = static_cast<T>(val);
+			}
+		}
+
+		/// Dispatch Unpack() according to the leaf's type name.  Returns false for types we don't know.
+		template <typename T>
+		bool UnpackByType(const std::string & typeName, char * buf, std::size_t skip, std::size_t n, T * out)
+		{
+			if (typeName == "Double_t")
+				Unpack<Double_t>(buf, skip, n, out);
+			else if (typeName == "Float_t")
+				Unpack<Float_t>(buf, skip, n, out);
+			else if (typeName == "Int_t")
+				Unpack<Int_t>(buf, skip, n, out);
+			else if (typeName == "UInt_t")
+				Unpack<UInt_t>(buf, skip, n, out);
+			else if (typeName == "Short_t")
+				Unpack<Short_t>(buf, skip, n, out);
+			else if (typeName == "UShort_t")
+				Unpack<UShort_t>(buf, skip, n, out);
+			else if (typeName == "Long64_t")
+				Unpack<Long64_t>(buf, skip, n, out);
+			else if (typeName == "Char_t")
+				Unpack<Char_t>(buf, skip, n, out);
+			else if (typeName == "UChar_t")
+				Unpack<UChar_t>(buf, skip, n, out);
+			else if (typeName == "Bool_t")
+				Unpack<Bool_t>(buf, skip, n, out);
+			else
+				return false;
+
+			return true;
+		}
+
+		TLeaf * FirstLeaf(TBranch * branch)
+		{
+			return static_cast<TLeaf*>(branch->GetListOfLeaves()->At(0));
+		}
+	}
+
+	// --------------------------------------
+	TTreeBatchReader::TTreeBatchReader(TTree * tree, TTreeBranchNames branchNames)
+		: fTree(tree),
+		  fGenerator(kUnknownGenerator),
+		  fBuffer(std::make_unique<TBufferFile>(TBuffer::kWrite, 32*1024))
+	{
+		if (!fTree)
+			throw std::runtime_error("NOvARwgt: TTreeBatchReader was given a null TTree");
+
+		fEnuBranch      = FindBranch(branchNames.Enu);
+		fQ2Branch       = FindBranch(branchNames.Q2);
+		fq0Branch       = FindBranch(branchNames.q0);
+		fq3Branch       = FindBranch(branchNames.q3);
+		fWBranch        = FindBranch(branchNames.W);
+		fyBranch        = FindBranch(branchNames.y);
+		fModeBranch     = FindBranch(branchNames.mode);
+		fCCNCBranch     = FindBranch(branchNames.ccnc);
+		fPdgBranch      = FindBranch(branchNames.pdg);
+		fTgtABranch     = FindBranch(branchNames.tgtA);
+		fHitNucBranch   = FindBranch(branchNames.hitnuc);
+		fNPiPlusBranch  = FindBranch(branchNames.npiplus);
+		fNPiZeroBranch  = FindBranch(branchNames.npizero);
+		fNPiMinusBranch = FindBranch(branchNames.npiminus);
+		fWgtsBranch     = FindBranch(branchNames.genieWgts);
+
+		// the bare minimum we need to make a sensible record
+		if (!fEnuBranch || !fPdgBranch || !fCCNCBranch || !fModeBranch)
+			throw std::runtime_error("NOvARwgt: TTreeBatchReader requires the neutrino energy, PDG, CC/NC, and mode branches");
+		if (!fq0Branch && !fyBranch)
+			throw std::runtime_error("NOvARwgt: TTreeBatchReader requires either a q0 or a y branch");
+		if (!fq3Branch && !fQ2Branch)
+			throw std::runtime_error("NOvARwgt: TTreeBatchReader requires either a q3 or a Q2 branch");
+
+		if (fWgtsBranch && FirstLeaf(fWgtsBranch)->GetLen() % 4 != 0)
+			throw std::runtime_error("NOvARwgt: TTreeBatchReader: GENIE weights branch '" + branchNames.genieWgts
+			                         + "' must have 4 entries per knob");
+	}
+
+	// --------------------------------------
+	// needs to be here, where TBufferFile is a complete type
+	TTreeBatchReader::~TTreeBatchReader() = default;
+
+	// --------------------------------------
+	TBranch * TTreeBatchReader::FindBranch(const std::string & name) const
+	{
+		if (name.empty())
+			return nullptr;
+		return fTree->GetBranch(name.c_str());
+	}
+
+	// --------------------------------------
+	Long64_t TTreeBatchReader::GetEntries() const
+	{
+		return fTree->GetEntries();
+	}
+
+	// --------------------------------------
+	void TTreeBatchReader::SetGeneratorInfo(novarwgt::Generator gen, std::vector<int> version, std::string configStr)
+	{
+		fGenerator = gen;
+		fGeneratorVersion = std::move(version);
+		fGeneratorConfigStr = std::move(configStr);
+	}
+
+	// --------------------------------------
+	template <typename T>
+	void TTreeBatchReader::ReadColumn(TBranch * branch, Long64_t first, std::size_t n, T * out)
+	{
+		TLeaf * leaf = FirstLeaf(branch);
+		std::size_t nRead = 0;
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,16,0)
+		const std::string typeName = leaf->GetTypeName();
+		if (branch->GetListOfLeaves()->GetEntriesFast() == 1 && leaf->GetLen() == 1 && !leaf->GetLeafCount()
+		    && branch->GetBulkRead().SupportsBulkRead())
+		{
+			while (nRead < n)
+			{
+				// bulk reads hand back a whole basket, so find where the one containing our entry starts
+				const Long64_t entry = first + nRead;
+				const Int_t basketIdx = TMath::BinarySearch(Long64_t(branch->GetWriteBasket() + 1), branch->GetBasketEntry(), entry);
+				const Long64_t basketFirst = branch->GetBasketEntry()[basketIdx];
+
+				const Int_t nInBasket = branch->GetBulkRead().GetEntriesSerialized(basketFirst, *fBuffer);
+				const auto skip = std::size_t(entry - basketFirst);
+				if (nInBasket <= 0 || std::size_t(nInBasket) <= skip)
+					break;
+
+				const std::size_t nUse = std::min(std::size_t(nInBasket) - skip, n - nRead);
+				if (!UnpackByType(typeName, fBuffer->GetCurrent(), skip, nUse, out + nRead))
+					break;
+				nRead += nUse;
+			}
+		}
+#endif
+
+		// anything bulk I/O couldn't handle goes through the ordinary per-entry read of this one branch
+		for ( ; nRead < n; nRead++)
+		{
+			branch->GetEntry(first + nRead);
+			out[nRead] = static_cast<T>(leaf->GetValue(0));
+		}
+	}
+
+	// --------------------------------------
+	void TTreeBatchReader::ReadWeights(Long64_t first, std::size_t n, novarwgt::EventBatch & batch)
+	{
+		// arrays aren't supported by the bulk interface, so these are read entry-by-entry
+		TLeaf * leaf = FirstLeaf(fWgtsBranch);
+		for (std::size_t evtIdx = 0; evtIdx < n; evtIdx++)
+		{
+			fWgtsBranch->GetEntry(first + evtIdx);
+			for (std::size_t knobIdx = 0; knobIdx < batch.nGenieKnobs; knobIdx++)
+			{
+				const std::size_t outIdx = evtIdx * batch.nGenieKnobs + knobIdx;
+				auto & vals = batch.genieWeights[outIdx];
+				vals.minus2sigma = leaf->GetValue(4*knobIdx);
+				vals.minus1sigma = leaf->GetValue(4*knobIdx + 1);
+				vals.plus1sigma  = leaf->GetValue(4*knobIdx + 2);
+				vals.plus2sigma  = leaf->GetValue(4*knobIdx + 3);
+
+				batch.genieWeightSet[outIdx] = !(std::isnan(vals.minus2sigma) && std::isnan(vals.minus1sigma)
+				                                 && std::isnan(vals.plus1sigma) && std::isnan(vals.plus2sigma));
+			}
+		}
+	}
+
+	// --------------------------------------
+	std::size_t TTreeBatchReader::ReadBatch(Long64_t firstEntry, std::size_t nEntries, novarwgt::EventBatch & batch)
+	{
+		const Long64_t nTotal = GetEntries();
+		const std::size_t n = (firstEntry < nTotal) ? std::min(nEntries, std::size_t(nTotal - firstEntry)) : 0;
+
+		std::size_t nKnobs = 0;
+		if (fWgtsBranch)
+			nKnobs = std::min(std::size_t(FirstLeaf(fWgtsBranch)->GetLen() / 4), std::size_t(novarwgt::kLastKnob));
+		batch.resize(n, nKnobs);
+		if (n == 0)
+			return 0;
+
+		batch.generator = fGenerator;
+		batch.generatorVersion = fGeneratorVersion;
+		batch.generatorConfigStr = fGeneratorConfigStr;
+
+		ReadColumn(fEnuBranch, firstEntry, n, batch.Enu.data());
+		ReadColumn(fPdgBranch, firstEntry, n, batch.nupdg.data());
+
+		fScratch.resize(n);
+		ReadColumn(fCCNCBranch, firstEntry, n, fScratch.data());
+		for (std::size_t idx = 0; idx < n; idx++)
+			batch.isCC[idx] = (fScratch[idx] == 0);
+
+		ReadColumn(fModeBranch, firstEntry, n, fScratch.data());
+		for (std::size_t idx = 0; idx < n; idx++)
+			batch.reaction[idx] = novarwgt::ReactionType(int(fScratch[idx]));
+
+		// energy transfer and inelasticity: either can be derived from the other
+		if (fq0Branch)
+			ReadColumn(fq0Branch, firstEntry, n, batch.q0.data());
+		if (fyBranch)
+			ReadColumn(fyBranch, firstEntry, n, batch.y.data());
+		for (std::size_t idx = 0; idx < n; idx++)
+		{
+			if (!fq0Branch)
+				batch.q0[idx] = batch.y[idx] * batch.Enu[idx];
+			else if (!fyBranch)
+				batch.y[idx] = batch.q0[idx] / batch.Enu[idx];
+		}
+
+		// three-momentum transfer: Q^2 = |q|^2 - q0^2
+		if (fq3Branch)
+			ReadColumn(fq3Branch, firstEntry, n, batch.q3.data());
+		else
+		{
+			ReadColumn(fQ2Branch, firstEntry, n, fScratch.data());
+			for (std::size_t idx = 0; idx < n; idx++)
+			{
+				// a negative |q|^2 would silently become NaN here.  usually it means the Q2 branch is really q^2 = -Q^2
+				const double q3sqr = fScratch[idx] + batch.q0[idx]*batch.q0[idx];
+				if (q3sqr < 0)
+					throw std::runtime_error("NOvARwgt: TTreeBatchReader: entry " + std::to_string(firstEntry + Long64_t(idx))
+					                         + " has Q2 = " + std::to_string(fScratch[idx]) + " < -q0^2 = " + std::to_string(-batch.q0[idx]*batch.q0[idx])
+					                         + ", so |q| can't be computed from it.  (Is the Q2 branch's sign convention Q2 = -q^2?)");
+				batch.q3[idx] = std::sqrt(q3sqr);
+			}
+		}
+
+		// the rest are optional.  fill with the same defaults EventRecord uses if they're not there
+		auto readOrFill = [&](TBranch * branch, auto & column, auto defaultVal)
+		{
+			if (branch)
+				ReadColumn(branch, firstEntry, n, column.data());
+			else
+				std::fill(column.begin(), column.end(), defaultVal);
+		};
+		readOrFill(fWBranch,        batch.W,          std::numeric_limits<double>::signaling_NaN());
+		readOrFill(fTgtABranch,     batch.A,          0u);
+		readOrFill(fHitNucBranch,   batch.struckNucl, -1);
+		readOrFill(fNPiPlusBranch,  batch.npiplus,    -1);
+		readOrFill(fNPiZeroBranch,  batch.npizero,    -1);
+		readOrFill(fNPiMinusBranch, batch.npiminus,   -1);
+
+		std::fill(batch.expectNoWeights.begin(), batch.expectNoWeights.end(), false);
+		if (fWgtsBranch)
+			ReadWeights(firstEntry, n, batch);
+
+		return n;
+	}
+
+}
@@ -0,0 +1,79 @@
+/*
+ * EventBatch.cxx:
+ *  Columnar container holding the truth info for many events at once.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#include "NOvARwgt/rwgt/EventBatch.h"
+
+namespace novarwgt
+{
+	// --------------------------------------
+	void EventBatch::resize(std::size_t nEvts, std::size_t nKnobs)
+	{
+		nupdg.resize(nEvts);
+		isCC.resize(nEvts);
+		reaction.resize(nEvts);
+		struckNucl.resize(nEvts);
+
+		Enu.resize(nEvts);
+		q0.resize(nEvts);
+		q3.resize(nEvts);
+		y.resize(nEvts);
+		W.resize(nEvts);
+
+		A.resize(nEvts);
+
+		npiplus.resize(nEvts);
+		npizero.resize(nEvts);
+		npiminus.resize(nEvts);
+
+		expectNoWeights.resize(nEvts);
+
+		nGenieKnobs = nKnobs;
+		genieWeights.resize(nEvts * nKnobs);
+		genieWeightSet.resize(nEvts * nKnobs);
+	}
+
+	// --------------------------------------
+	void EventBatch::FillRecord(std::size_t idx, novarwgt::EventRecord & rec) const
+	{
+		rec.generator = generator;
+		rec.generatorVersion = generatorVersion;   // vector & string assignment reuse existing capacity
+		rec.generatorConfigStr = generatorConfigStr;
+
+		rec.nupdg = nupdg[idx];
+		rec.isCC = isCC[idx];
+		rec.reaction = reaction[idx];
+		rec.struckNucl = struckNucl[idx];
+
+		rec.Enu = Enu[idx];
+		// the direction of q isn't stored, so just put it along z
+		rec.q.SetPxPyPzE(0, 0, q3[idx], q0[idx]);
+		rec.y = y[idx];
+		rec.W = W[idx];
+
+		rec.A = A[idx];
+
+		rec.npiplus = npiplus[idx];
+		rec.npizero = npizero[idx];
+		rec.npiminus = npiminus[idx];
+
+		rec.expectNoWeights = expectNoWeights[idx];
+		rec.origGenieEvt = nullptr;
+
+		// clear() + resize() keeps the capacity, and leaves every knob marked 'not set'
+		rec.genieWeights.clear();
+		rec.genieWeights.resize(nGenieKnobs);
+		const std::size_t offset = idx * nGenieKnobs;
+		for (std::size_t knobIdx = 0; knobIdx < nGenieKnobs; knobIdx++)
+		{
+			if (genieWeightSet[offset + knobIdx])
+				rec.genieWeights[knobIdx] = genieWeights[offset + knobIdx];
+		}
+
+		rec.Finalize();
+	}
+}
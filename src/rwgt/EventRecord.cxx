@@ -6,10 +6,15 @@
  *      Author: J. Wolcott <jwolcott@fnal.gov>
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstddef>
+#include <cstdlib>
 #include <iostream>
 
 #include "NOvARwgt/rwgt/EventRecord.h"
+#include "NOvARwgt/rwgt/genie/StoredWgtSpline.h"
 
 namespace novarwgt
 {
@@ -46,6 +51,120 @@ namespace novarwgt
 
 	}
 
+	// --------------------------------------
+	struct ReweightList::SplineCache
+	{
+		std::vector<std::pair<std::size_t, StoredWgtSpline>> splines;   ///< (knob, its spline), sorted by knob
+	};
+
+	// --------------------------------------
+	void ReweightList::BuildSplines(const std::vector<novarwgt::ReweightKnob> & knobs)
+	{
+		auto cache = std::make_shared<SplineCache>();
+		for (const auto & knob : knobs)
+		{
+			if (IsSet(knob))
+				cache->splines.emplace_back(std::size_t(knob), StoredWgtSpline(fWeights[knob]));
+		}
+		// (the cache is shared with copies of this list, so it's replaced rather than modified)
+		if (fSplines)
+		{
+			for (const auto & knobSpline : fSplines->splines)
+			{
+				if (std::find(knobs.begin(), knobs.end(), knobSpline.first) == knobs.end())
+					cache->splines.push_back(knobSpline);
+			}
+		}
+		std::sort(cache->splines.begin(), cache->splines.end(),
+		          [](const std::pair<std::size_t, StoredWgtSpline> & a, const std::pair<std::size_t, StoredWgtSpline> & b) { return a.first < b.first; });
+
+		if (cache->splines.empty())
+			fSplines.reset();
+		else
+			fSplines = std::move(cache);
+	}
+
+	// --------------------------------------
+	const StoredWgtSpline * ReweightList::Spline(std::size_t pos) const
+	{
+		if (!fSplines || !IsSet(pos))
+			return nullptr;
+
+		const auto & splines = fSplines->splines;
+		auto itSpline = std::lower_bound(splines.begin(), splines.end(), pos,
+		                                 [](const std::pair<std::size_t, StoredWgtSpline> & knobSpline, std::size_t knob) { return knobSpline.first < knob; });
+
+		// the non-const operator[] hands out writable references, so check the table is still what the spline was made from
+		if (itSpline == splines.end() || itSpline->first != pos || !itSpline->second.BuiltFrom(fWeights[pos]))
+			return nullptr;
+		return &itSpline->second;
+	}
+
+	// --------------------------------------
+	std::uint64_t EventRecord::NextSerial()
+	{
+		// only uniqueness matters, not ordering between threads
+		static std::atomic<std::uint64_t> counter(0);
+		return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
+	// --------------------------------------
+	void EventRecord::Finalize()
+	{
+		fSerial = NextSerial();
+		fClassBits = Classify();
+	}
+
+	// --------------------------------------
+	std::uint32_t EventRecord::Classify() const
+	{
+		std::uint32_t bits = isCC ? kEvtCC : kEvtNC;
+
+		if (nupdg > 0)
+			bits |= kEvtNu;
+		else if (nupdg < 0)
+			bits |= kEvtNubar;
+
+		switch (std::abs(nupdg))
+		{
+			case 12: bits |= kEvtNuE;   break;
+			case 14: bits |= kEvtNuMu;  break;
+			case 16: bits |= kEvtNuTau; break;
+			default: break;
+		}
+
+		switch (reaction)
+		{
+			case kScQuasiElastic:  bits |= kEvtQE;  break;
+			case kScResonant:      bits |= kEvtRES; break;
+			case kScDeepInelastic: bits |= kEvtDIS; break;
+			case kScCoherent:      bits |= kEvtCOH; break;
+			case kScMEC:           bits |= kEvtMEC; break;
+			default: break;
+		}
+
+		if (A == 1)
+			bits |= kEvtFreeNucleon;
+
+		if (struckNucl == 2212)
+			bits |= kEvtStruckProton;
+		else if (struckNucl == 2112)
+			bits |= kEvtStruckNeutron;
+
+		const int npion = npiplus + npizero + npiminus;
+		if (npion >= 3)
+			bits |= kEvt3PlusPi;
+		else if (npion >= 0)
+			bits |= kEvt0Pi << npion;
+
+		if (W >= 0 && W <= 1.7)
+			bits |= kEvtLowW;
+		if (W >= 1.7)
+			bits |= kEvtHighW;
+
+		return bits;
+	}
+
 	// --------------------------------------
 	void EventRecord::PrintTo(std::ostream &stream) const
 	{
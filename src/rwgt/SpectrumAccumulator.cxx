@@ -0,0 +1,167 @@
+/*
+ * SpectrumAccumulator.cxx:
+ *  Weights events and fills CV + systematically shifted spectra with them in one fused pass.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "TH1.h"
+
+#include "NOvARwgt/rwgt/EvalContext.h"
+#include "NOvARwgt/rwgt/EventBatch.h"
+#include "NOvARwgt/rwgt/EventRecord.h"
+#include "NOvARwgt/rwgt/ISystKnob.h"
+#include "NOvARwgt/rwgt/SpectrumAccumulator.h"
+#include "NOvARwgt/rwgt/Tune.h"
+#include "NOvARwgt/util/WorkerPool.h"
+
+namespace novarwgt
+{
+	// --------------------------------------
+	SpectrumAccumulator::SpectrumAccumulator(const novarwgt::Tune & tune,
+	                                         std::size_t nBins,
+	                                         BinFunction binFn,
+	                                         const std::vector<novarwgt::KnobShift> & shifts,
+	                                         novarwgt::InputVals params)
+		: fTune(tune), fNBins(nBins), fBinFn(std::move(binFn)), fParams(std::move(params))
+	{
+		// look the knobs up once here rather than by name for every event
+		for (const auto & shift : shifts)
+		{
+			fShiftKnobs.push_back(tune.Knob(tune.FindKnob(shift.knob)));
+			fShiftSigmas.push_back(shift.sigma);
+		}
+
+		Reset();
+	}
+
+	// --------------------------------------
+	void SpectrumAccumulator::Accumulate(const novarwgt::EventBatch & batch, unsigned int nThreads)
+	{
+		// a single thread may as well be the calling one
+		AccumulateChunks(batch, nThreads == 1 ? nullptr : &novarwgt::WorkerPool::Shared(nThreads));
+	}
+
+	// --------------------------------------
+	void SpectrumAccumulator::Accumulate(const novarwgt::EventBatch & batch, novarwgt::WorkerPool & pool)
+	{
+		AccumulateChunks(batch, &pool);
+	}
+
+	// --------------------------------------
+	void SpectrumAccumulator::AccumulateChunks(const novarwgt::EventBatch & batch, novarwgt::WorkerPool * pool)
+	{
+		if (batch.size() == 0)
+			return;
+
+		const std::size_t nVals = fSumW.size();
+		const std::size_t nChunks = (batch.size() + kChunkSize - 1) / kChunkSize;
+
+		// chunks are done a 'wave' at a time, so only that many partial spectra are ever held.
+		// how many chunks make up a wave doesn't change the result, only the memory use.
+		const std::size_t chunksPerWave = std::min(nChunks, std::size_t(4) * (pool ? pool->NThreads() : 1));
+		std::vector<double> sumW(chunksPerWave * nVals), sumW2(chunksPerWave * nVals);
+
+		for (std::size_t firstChunk = 0; firstChunk < nChunks; firstChunk += chunksPerWave)
+		{
+			const std::size_t nWaveChunks = std::min(chunksPerWave, nChunks - firstChunk);
+			std::fill(sumW.begin(), sumW.end(), 0.);
+			std::fill(sumW2.begin(), sumW2.end(), 0.);
+
+			auto fillChunk = [&](std::size_t waveChunkIdx)
+			{
+				double * w = sumW.data() + waveChunkIdx * nVals;
+				double * w2 = sumW2.data() + waveChunkIdx * nVals;
+				const std::size_t begin = (firstChunk + waveChunkIdx) * kChunkSize;
+				const std::size_t end = std::min(begin + kChunkSize, batch.size());
+
+				novarwgt::EvalContext ctx;
+				novarwgt::EventRecord evt;   // refilled in place for each row
+				for (std::size_t evtIdx = begin; evtIdx < end; evtIdx++)
+				{
+					batch.FillRecord(evtIdx, evt);
+					const int bin = fBinFn(evt);
+					if (bin < 0 || std::size_t(bin) >= fNBins)
+						continue;
+
+					// the CV and all the shifts share one evaluation of each weighter
+					novarwgt::EvalContextScope scope(ctx, evt, fParams);
+					fTune.EvaluatePlan(evt, fParams);
+					const double cvWgt = fTune.EventWeight(evt, fParams);
+					w[bin] += cvWgt;
+					w2[bin] += cvWgt * cvWgt;
+
+					for (std::size_t shiftIdx = 0; shiftIdx < fShiftKnobs.size(); shiftIdx++)
+					{
+						const double wgt = cvWgt * fShiftKnobs[shiftIdx]->GetWeight(fShiftSigmas[shiftIdx], evt, fParams);
+						const std::size_t idx = (shiftIdx + 1) * fNBins + bin;
+						w[idx] += wgt;
+						w2[idx] += wgt * wgt;
+					}
+				}
+			};
+
+			if (pool)
+				pool->Run(nWaveChunks, fillChunk);
+			else
+			{
+				for (std::size_t waveChunkIdx = 0; waveChunkIdx < nWaveChunks; waveChunkIdx++)
+					fillChunk(waveChunkIdx);
+			}
+
+			// always merged in chunk order, so the sums don't depend on the threads at all
+			for (std::size_t waveChunkIdx = 0; waveChunkIdx < nWaveChunks; waveChunkIdx++)
+			{
+				for (std::size_t idx = 0; idx < nVals; idx++)
+				{
+					fSumW[idx] += sumW[waveChunkIdx * nVals + idx];
+					fSumW2[idx] += sumW2[waveChunkIdx * nVals + idx];
+				}
+			}
+		}
+	}
+
+	// --------------------------------------
+	std::vector<double> SpectrumAccumulator::Contents(std::size_t specIdx) const
+	{
+		if (specIdx >= NSpectra())
+			throw std::runtime_error("NOvARwgt: SpectrumAccumulator: no spectrum with index " + std::to_string(specIdx));
+		return std::vector<double>(fSumW.begin() + specIdx * fNBins, fSumW.begin() + (specIdx + 1) * fNBins);
+	}
+
+	// --------------------------------------
+	std::vector<double> SpectrumAccumulator::SumW2(std::size_t specIdx) const
+	{
+		if (specIdx >= NSpectra())
+			throw std::runtime_error("NOvARwgt: SpectrumAccumulator: no spectrum with index " + std::to_string(specIdx));
+		return std::vector<double>(fSumW2.begin() + specIdx * fNBins, fSumW2.begin() + (specIdx + 1) * fNBins);
+	}
+
+	// --------------------------------------
+	void SpectrumAccumulator::FillHist(std::size_t specIdx, TH1 * hist) const
+	{
+		if (specIdx >= NSpectra())
+			throw std::runtime_error("NOvARwgt: SpectrumAccumulator: no spectrum with index " + std::to_string(specIdx));
+		if (!hist || std::size_t(hist->GetNbinsX()) != fNBins)
+			throw std::runtime_error("NOvARwgt: SpectrumAccumulator::FillHist(): histogram must have " + std::to_string(fNBins) + " bins");
+
+		for (std::size_t bin = 0; bin < fNBins; bin++)
+		{
+			hist->SetBinContent(int(bin) + 1, fSumW[specIdx * fNBins + bin]);
+			hist->SetBinError(int(bin) + 1, std::sqrt(fSumW2[specIdx * fNBins + bin]));
+		}
+	}
+
+	// --------------------------------------
+	void SpectrumAccumulator::Reset()
+	{
+		fSumW.assign(NSpectra() * fNBins, 0.);
+		fSumW2.assign(NSpectra() * fNBins, 0.);
+	}
+}
@@ -6,9 +6,16 @@
  *      Author: J. Wolcott <jwolcott@fnal.gov>
  */
 
-#include <numeric>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "NOvARwgt/util/InputVals.h"
+#include "NOvARwgt/rwgt/EvalContext.h"
+#include "NOvARwgt/rwgt/EventBatch.h"
 #include "NOvARwgt/rwgt/EventRecord.h"
 #include "NOvARwgt/rwgt/Tune.h"
 
@@ -16,39 +23,192 @@
 #include "NOvARwgt/interfaces/GenieInterface.h"
 
 
+namespace
+{
+	/// The context Tune methods use when the caller hasn't set one up.
+	/// One per thread, so its storage gets reused from event to event.
+	novarwgt::EvalContext & TuneEvalContext()
+	{
+		static thread_local novarwgt::EvalContext ctx;
+		return ctx;
+	}
+
+	/// Depth-first: append \a wgtr to \a plan after everything it depends on.
+	/// \a visiting is true for weighters whose dependencies are still being added
+	/// (so meeting one again means a cycle) and false for those already in the plan.
+	void AddToPlan(const novarwgt::IWeightGenerator * wgtr,
+	               std::unordered_map<const novarwgt::IWeightGenerator*, bool> & visiting,
+	               std::vector<const novarwgt::IWeightGenerator*> & plan)
+	{
+		if (!wgtr)
+			return;
+
+		auto itWgtr = visiting.find(wgtr);
+		if (itWgtr != visiting.end())
+		{
+			if (itWgtr->second)
+				throw std::runtime_error("NOvARwgt: Tune: weighter '" + wgtr->GetName() + "' depends on itself");
+			return;
+		}
+
+		visiting[wgtr] = true;
+		for (const auto & dep : wgtr->Dependencies())
+			AddToPlan(dep, visiting, plan);
+		visiting[wgtr] = false;
+
+		plan.push_back(wgtr);
+	}
+}
+
 namespace novarwgt
 {
 	// --------------------------------------
-	Tune::Tune(std::unordered_map<std::string, const novarwgt::IWeightGenerator*>  wgts,
+	Tune::Tune(std::vector<std::pair<std::string, const novarwgt::IWeightGenerator*>> wgts,
 	           SystKnobSet knobs)
-		: fWeighters(std::move(wgts))
 	{
+		for (auto & wgtrPair : wgts)
+		{
+			if (!fWeighterIdxs.emplace(wgtrPair.first, fWeighters.size()).second)
+				continue;
+			fWeighters.push_back(wgtrPair.second);
+			fWeighterNames.push_back(std::move(wgtrPair.first));
+		}
+
 		for (const auto & knob : knobs)
 		{
-			fSystKnobs.emplace(knob->GetName(), knob);
-			fSystKnobNames.emplace_back(knob->GetName());
+			if (!fSystKnobIdxs.emplace(knob->GetName(), fSystKnobs.size()).second)
+				continue;
+			fSystKnobs.push_back(knob);
+			fSystKnobNames.push_back(knob->GetName());
+		}
+
+		CompilePlan();
+		GroupKnobFamilies();
+	}
+
+	// --------------------------------------
+	void Tune::CompilePlan()
+	{
+		std::unordered_map<const novarwgt::IWeightGenerator*, bool> visiting;
+		for (const auto & wgtr : fWeighters)
+			AddToPlan(wgtr, visiting, fPlan);
+		for (const auto & knob : fSystKnobs)
+		{
+			for (const auto & wgtr : knob->Dependencies())
+				AddToPlan(wgtr, visiting, fPlan);
+		}
+	}
+
+	// --------------------------------------
+	void Tune::GroupKnobFamilies()
+	{
+		for (std::size_t knobIdx = 0; knobIdx < fSystKnobs.size(); knobIdx++)
+		{
+			const novarwgt::ISystKnobFamily * family = fSystKnobs[knobIdx]->Family();
+			if (!family)
+			{
+				fLoneKnobs.push_back(knobIdx);
+				continue;
+			}
+
+			auto itFamily = std::find_if(fKnobFamilies.begin(), fKnobFamilies.end(),
+			                             [family](const KnobFamily & knobFamily) { return knobFamily.family == family; });
+			if (itFamily == fKnobFamilies.end())
+			{
+				fKnobFamilies.push_back({family, std::vector<std::size_t>(family->Members().size(), fSystKnobs.size())});
+				itFamily = std::prev(fKnobFamilies.end());
+			}
+			itFamily->knobIdxs[family->SlotOf(fSystKnobs[knobIdx])] = knobIdx;
+		}
+	}
+
+	// --------------------------------------
+	void Tune::EvaluatePlan(const novarwgt::EventRecord & evt, const novarwgt::InputVals & params) const
+	{
+		if (evt.expectNoWeights)
+			return;
+
+		// with nowhere to keep the weights, there'd be no point
+		const novarwgt::EvalContext * ctx = novarwgt::EvalContext::Active();
+		if (!ctx || !ctx->Matches(evt, params))
+			return;
+
+		// dependencies come first, so each GetWeight() here only computes its own weighter
+		for (const auto & wgtr : fPlan)
+		{
+			if (wgtr->EvtGenIsSupported(evt, params))
+				wgtr->GetWeight(evt, params);
 		}
 	}
 
 	// --------------------------------------
 	double Tune::EventWeight(const novarwgt::EventRecord & evt, const novarwgt::InputVals & params) const
 	{
-		auto wgtsByComponent = this->EventWeightComponents(evt, params);
-		return std::accumulate(wgtsByComponent.begin(), wgtsByComponent.end(), 1.0,
-		                       [](double w1, const Tune::NamedWeight& w2){ return w1 * w2.weight;});
+		// same as multiplying together the output of EventWeightComponents(),
+		// but without needing anywhere to put the components
+		novarwgt::EvalContextScope scope(TuneEvalContext(), evt, params);
+
+		double wgt = 1.0;
+		for (const auto & wgtr : fWeighters)
+			wgt *= wgtr->GetWeight(evt, params);
+		return wgt;
+	}
+
+	// --------------------------------------
+	void Tune::EventWeights(const novarwgt::EventBatch & batch,
+	                        std::vector<double> & wgts,
+	                        const novarwgt::InputVals & params) const
+	{
+		wgts.resize(batch.size());
+
+		// one record, refilled in place for each row
+		novarwgt::EventRecord evt;
+		for (std::size_t idx = 0; idx < batch.size(); idx++)
+		{
+			batch.FillRecord(idx, evt);
+			wgts[idx] = this->EventWeight(evt, params);
+		}
 	}
 
 	// --------------------------------------
 	std::vector<Tune::NamedWeight>
 		Tune::EventWeightComponents(const novarwgt::EventRecord & evt, const novarwgt::InputVals & params) const
 	{
+		std::vector<double> wgtVals(fWeighters.size());
+		this->EventWeightComponents(evt, wgtVals.data(), wgtVals.size(), params);
+
 		std::vector<Tune::NamedWeight> wgts;
-		for (const auto & wgtrPair : fWeighters)
-			wgts.emplace_back(wgtrPair.first, wgtrPair.second->GetWeight(evt, params));
+		wgts.reserve(fWeighters.size());
+		for (std::size_t wgtrIdx = 0; wgtrIdx < fWeighters.size(); wgtrIdx++)
+			wgts.emplace_back(fWeighterNames[wgtrIdx], wgtVals[wgtrIdx]);
 
 		return wgts;
 	}
 
+	// --------------------------------------
+	void Tune::EventWeightComponents(const novarwgt::EventRecord & evt,
+	                                 double * wgts,
+	                                 std::size_t nWgts,
+	                                 const novarwgt::InputVals & params) const
+	{
+		if (nWgts < fWeighters.size())
+			throw std::runtime_error("NOvARwgt: Tune::EventWeightComponents(): output buffer has room for " + std::to_string(nWgts)
+			                         + " weights, but there are " + std::to_string(fWeighters.size()) + " weighters");
+
+		novarwgt::EvalContextScope scope(TuneEvalContext(), evt, params);
+
+		for (std::size_t wgtrIdx = 0; wgtrIdx < fWeighters.size(); wgtrIdx++)
+			wgts[wgtrIdx] = fWeighters[wgtrIdx]->GetWeight(evt, params);
+	}
+
+	// --------------------------------------
+	double Tune::EventWeighterWeight(WeighterHandle wgtr, const novarwgt::EventRecord & evt, const novarwgt::InputVals & params) const
+	{
+		novarwgt::EvalContextScope scope(TuneEvalContext(), evt, params);
+
+		return fWeighters.at(wgtr.idx)->GetWeight(evt, params);
+	}
+
 	// --------------------------------------
 	double Tune::EventSystKnobWeight(const std::string &knobName,
 	                                 double sigma,
@@ -56,9 +216,65 @@ namespace novarwgt
 	                                 const InputVals &params,
 	                                 bool relativeToCV) const
 	{
-		double wgt = fSystKnobs.at(knobName)->GetWeight(sigma, evt, params);
+		return EventSystKnobWeight(FindKnob(knobName), sigma, evt, params, relativeToCV);
+	}
+
+	// --------------------------------------
+	double Tune::EventSystKnobWeight(KnobHandle knob,
+	                                 double sigma,
+	                                 const novarwgt::EventRecord &evt,
+	                                 const InputVals &params,
+	                                 bool relativeToCV) const
+	{
+		novarwgt::EvalContextScope scope(TuneEvalContext(), evt, params);
+
+		double wgt = fSystKnobs.at(knob.idx)->GetWeight(sigma, evt, params);
+		if (relativeToCV)
+		{
+			double cvWgt = this->EventWeight(evt, params);
+			if (cvWgt > 0)
+				wgt /= cvWgt;
+			else
+				wgt = 0;
+		}
+
+		return wgt;
+	}
+
+	// --------------------------------------
+	double Tune::ShiftedEventWeight(const novarwgt::EventRecord & evt,
+	                                const std::vector<double> & sigmas,
+	                                const novarwgt::InputVals & params,
+	                                bool relativeToCV) const
+	{
+		if (sigmas.size() != fSystKnobs.size())
+			throw std::runtime_error("NOvARwgt: Tune::ShiftedEventWeight() got " + std::to_string(sigmas.size())
+			                         + " sigma values for " + std::to_string(fSystKnobs.size()) + " knobs");
+
+		novarwgt::EvalContextScope scope(TuneEvalContext(), evt, params);
+		this->EvaluatePlan(evt, params);
+
+		double wgt = 1.0;
+		for (const auto & knobIdx : fLoneKnobs)
+			wgt *= fSystKnobs[knobIdx]->GetWeight(sigmas[knobIdx], evt, params);
+
+		// every other member of a family is 1 for this event, so only the one in the event's slot is needed
+		for (const auto & knobFamily : fKnobFamilies)
+		{
+			// once per family, and whether or not any member applies, just as each member's GetWeight() would
+			knobFamily.family->TestIfEvtGenIsSupported(evt, params);
+
+			const int slot = knobFamily.family->Slot(evt);
+			if (slot == novarwgt::ISystKnobFamily::kNoSlot)
+				continue;
+			const std::size_t knobIdx = knobFamily.knobIdxs[slot];
+			if (knobIdx < fSystKnobs.size())
+				wgt *= knobFamily.family->SlotWeight(slot, sigmas[knobIdx], evt, params);
+		}
+
 		if (relativeToCV)
 		{
+			// the CV weighters were evaluated with the rest of the plan
 			double cvWgt = this->EventWeight(evt, params);
 			if (cvWgt > 0)
 				wgt /= cvWgt;
@@ -76,10 +292,34 @@ namespace novarwgt
 	}
 
 	// --------------------------------------
-	const std::unordered_map<std::string, const novarwgt::ISystKnob *> & Tune::SystKnobs() const
+	const std::vector<const novarwgt::ISystKnob *> & Tune::SystKnobs() const
 	{
 		return fSystKnobs;
 	}
 
+	// --------------------------------------
+	const std::vector<std::string> & Tune::WeighterNames() const
+	{
+		return fWeighterNames;
+	}
+
+	// --------------------------------------
+	KnobHandle Tune::FindKnob(const std::string & knobName) const
+	{
+		auto itKnob = fSystKnobIdxs.find(knobName);
+		if (itKnob == fSystKnobIdxs.end())
+			throw std::runtime_error("NOvARwgt: Tune has no knob named '" + knobName + "'");
+		return KnobHandle{itKnob->second};
+	}
+
+	// --------------------------------------
+	WeighterHandle Tune::FindWeighter(const std::string & wgtrName) const
+	{
+		auto itWgtr = fWeighterIdxs.find(wgtrName);
+		if (itWgtr == fWeighterIdxs.end())
+			throw std::runtime_error("NOvARwgt: Tune has no weighter named '" + wgtrName + "'");
+		return WeighterHandle{itWgtr->second};
+	}
+
 
 }
\ No newline at end of file
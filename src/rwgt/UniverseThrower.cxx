@@ -0,0 +1,169 @@
+/*
+ * UniverseThrower.cxx:
+ *  Random "universes" (sigma vectors for all of a Tune's knobs) evaluated for each event in a single pass.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TH1.h"
+#include "TRandom3.h"
+
+#include "NOvARwgt/rwgt/EvalContext.h"
+#include "NOvARwgt/rwgt/EventRecord.h"
+#include "NOvARwgt/rwgt/ISystKnob.h"
+#include "NOvARwgt/rwgt/Tune.h"
+#include "NOvARwgt/rwgt/UniverseThrower.h"
+
+namespace
+{
+	/// Lower-triangular L with L L^T = cov (cov is n x n, row-major)
+	std::vector<double> Cholesky(const std::vector<double> & cov, std::size_t n)
+	{
+		std::vector<double> chol(n * n, 0.);
+		for (std::size_t row = 0; row < n; row++)
+		{
+			for (std::size_t col = 0; col <= row; col++)
+			{
+				if (cov[row * n + col] != cov[col * n + row])
+					throw std::runtime_error("NOvARwgt: UniverseThrower: covariance matrix is not symmetric");
+
+				double sum = cov[row * n + col];
+				for (std::size_t k = 0; k < col; k++)
+					sum -= chol[row * n + k] * chol[col * n + k];
+
+				if (row == col)
+				{
+					if (!(sum > 0))
+						throw std::runtime_error("NOvARwgt: UniverseThrower: covariance matrix is not positive definite");
+					chol[row * n + col] = std::sqrt(sum);
+				}
+				else
+					chol[row * n + col] = sum / chol[col * n + col];
+			}
+		}
+		return chol;
+	}
+}
+
+namespace novarwgt
+{
+	// --------------------------------------
+	UniverseThrower::UniverseThrower(const novarwgt::Tune & tune, std::size_t nUniverses, unsigned int seed)
+		: fTune(tune), fNUniverses(nUniverses), fKnobNames(tune.KnobNames()), fKnobs(tune.SystKnobs())
+	{
+		Throw(seed, {});
+	}
+
+	// --------------------------------------
+	UniverseThrower::UniverseThrower(const novarwgt::Tune & tune, std::size_t nUniverses, unsigned int seed,
+	                                 const std::vector<double> & covariance)
+		: fTune(tune), fNUniverses(nUniverses), fKnobNames(tune.KnobNames()), fKnobs(tune.SystKnobs())
+	{
+		const std::size_t nKnobs = fKnobs.size();
+		if (covariance.size() != nKnobs * nKnobs)
+			throw std::runtime_error("NOvARwgt: UniverseThrower: covariance matrix has " + std::to_string(covariance.size())
+			                         + " entries, but there are " + std::to_string(nKnobs) + " knobs");
+
+		Throw(seed, Cholesky(covariance, nKnobs));
+	}
+
+	// --------------------------------------
+	void UniverseThrower::Throw(unsigned int seed, const std::vector<double> & chol)
+	{
+		const std::size_t nKnobs = fKnobs.size();
+		fSigmas.assign(nKnobs * fNUniverses, 0.);
+
+		// draw universe by universe, so that the first N universes don't depend on how many are thrown in total
+		TRandom3 rng(seed);
+		std::vector<double> gaus(nKnobs);
+		for (std::size_t univIdx = 0; univIdx < fNUniverses; univIdx++)
+		{
+			for (auto & g : gaus)
+				g = rng.Gaus(0, 1);
+
+			for (std::size_t knobIdx = 0; knobIdx < nKnobs; knobIdx++)
+			{
+				double sigma = gaus[knobIdx];
+				if (!chol.empty())
+				{
+					sigma = 0;
+					for (std::size_t k = 0; k <= knobIdx; k++)
+						sigma += chol[knobIdx * nKnobs + k] * gaus[k];
+				}
+				fSigmas[knobIdx * fNUniverses + univIdx] = sigma;
+			}
+		}
+	}
+
+	// --------------------------------------
+	void UniverseThrower::EventWeights(const novarwgt::EventRecord & evt, double * wgts, const novarwgt::InputVals & params) const
+	{
+		// every knob in every universe shares one evaluation of each weighter for this event
+		static thread_local novarwgt::EvalContext ctx;
+		novarwgt::EvalContextScope scope(ctx, evt, params);
+		fTune.EvaluatePlan(evt, params);
+
+		const double cvWgt = fTune.EventWeight(evt, params);
+		for (std::size_t univIdx = 0; univIdx < fNUniverses; univIdx++)
+			wgts[univIdx] = cvWgt;
+
+		// one knob's weights in all the universes at a time, so the knob can set up whatever it needs for the event just once
+		// (see ISystKnob::GetWeights()), and multiplying them in is a plain vectorizable loop
+		static thread_local std::vector<double> knobWgts;
+		knobWgts.resize(fNUniverses);
+
+		for (std::size_t knobIdx = 0; knobIdx < fKnobs.size(); knobIdx++)
+		{
+			const novarwgt::ISystKnob * knob = fKnobs[knobIdx];
+			// family members only move events in their own slot, which the family can say without evaluating anything.
+			// (other knobs are cheaper to just evaluate than to ask whether they can affect the event first)
+			if (const novarwgt::ISystKnobFamily * family = knob->Family())
+			{
+				family->TestIfEvtGenIsSupported(evt, params);   // GetWeights() would have, whatever the slot
+				if (family->Slot(evt) != family->SlotOf(knob))
+					continue;
+			}
+
+			knob->GetWeights(fSigmas.data() + knobIdx * fNUniverses, fNUniverses, evt, params, knobWgts.data());
+			for (std::size_t univIdx = 0; univIdx < fNUniverses; univIdx++)
+				wgts[univIdx] *= knobWgts[univIdx];
+		}
+	}
+
+	// --------------------------------------
+	void UniverseThrower::Weights(const std::vector<novarwgt::EventRecord> & evts,
+	                              std::vector<double> & wgts,
+	                              const novarwgt::InputVals & params) const
+	{
+		wgts.resize(evts.size() * fNUniverses);
+		for (std::size_t evtIdx = 0; evtIdx < evts.size(); evtIdx++)
+			EventWeights(evts[evtIdx], wgts.data() + evtIdx * fNUniverses, params);
+	}
+
+	// --------------------------------------
+	void UniverseThrower::FillHists(const std::vector<novarwgt::EventRecord> & evts,
+	                                const std::function<double(const novarwgt::EventRecord &)> & var,
+	                                const std::vector<TH1*> & hists,
+	                                const novarwgt::InputVals & params) const
+	{
+		if (hists.size() != fNUniverses)
+			throw std::runtime_error("NOvARwgt: UniverseThrower::FillHists() got " + std::to_string(hists.size())
+			                         + " histograms for " + std::to_string(fNUniverses) + " universes");
+
+		// only one event's worth of weights is ever stored
+		std::vector<double> wgts(fNUniverses);
+		for (const auto & evt : evts)
+		{
+			EventWeights(evt, wgts.data(), params);
+			const double x = var(evt);
+			for (std::size_t univIdx = 0; univIdx < fNUniverses; univIdx++)
+				hists[univIdx]->Fill(x, wgts[univIdx]);
+		}
+	}
+}
@@ -0,0 +1,163 @@
+/*
+ * WeightedSample.cxx:
+ *  A sample of events whose total weights are kept up to date as knob sigmas change, for use in fits.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "NOvARwgt/rwgt/EventRecord.h"
+#include "NOvARwgt/rwgt/ISystKnob.h"
+#include "NOvARwgt/rwgt/Tune.h"
+#include "NOvARwgt/rwgt/WeightedSample.h"
+
+namespace
+{
+	/// How many ratio updates are allowed before the products are rebuilt from scratch
+	const unsigned int kMaxUpdates = 1000;
+
+	bool IsGood(double factor)
+	{
+		return factor != 0 && std::isfinite(factor);
+	}
+}
+
+namespace novarwgt
+{
+	// --------------------------------------
+	WeightedSample::WeightedSample(const novarwgt::Tune & tune,
+	                               const std::vector<novarwgt::EventRecord> & evts,
+	                               novarwgt::InputVals params)
+		: fEvts(evts), fParams(std::move(params)),
+		  fKnobNames(tune.KnobNames()),
+		  fKnobs(tune.SystKnobs()),
+		  fSigmas(fKnobNames.size(), 0.),
+		  fAffected(fKnobNames.size()),
+		  fFactors(fKnobNames.size()),
+		  fCVWgts(evts.size()),
+		  fProducts(evts.size(), 1.),
+		  fNBad(evts.size(), 0)
+	{
+		for (std::size_t evtIdx = 0; evtIdx < fEvts.size(); evtIdx++)
+		{
+			const auto & evt = fEvts[evtIdx];
+			// the CV and every knob share one evaluation of each weighter for this event
+			novarwgt::EvalContextScope scope(fCtx, evt, fParams);
+			tune.EvaluatePlan(evt, fParams);
+
+			fCVWgts[evtIdx] = tune.EventWeight(evt, fParams);
+
+			for (std::size_t knobIdx = 0; knobIdx < fKnobs.size(); knobIdx++)
+			{
+				const novarwgt::ISystKnob * knob = fKnobs[knobIdx];
+				if (!knob->CanAffect(evt, fParams))
+					continue;
+
+				fAffected[knobIdx].push_back(evtIdx);
+				fFactors[knobIdx].push_back(knob->GetWeight(0, evt, fParams));
+			}
+		}
+
+		Rebuild();
+	}
+
+	// --------------------------------------
+	void WeightedSample::SetSigma(std::size_t knobIdx, double sigma)
+	{
+		if (knobIdx >= fKnobs.size())
+			throw std::runtime_error("NOvARwgt: WeightedSample::SetSigma(): knob index " + std::to_string(knobIdx)
+			                         + " out of range (" + std::to_string(fKnobs.size()) + " knobs)");
+		if (sigma == fSigmas[knobIdx])
+			return;
+		fSigmas[knobIdx] = sigma;
+
+		const novarwgt::ISystKnob * knob = fKnobs[knobIdx];
+		const auto & affected = fAffected[knobIdx];
+		auto & factors = fFactors[knobIdx];
+		for (std::size_t i = 0; i < affected.size(); i++)
+		{
+			const std::size_t evtIdx = affected[i];
+			const auto & evt = fEvts[evtIdx];
+			novarwgt::EvalContextScope scope(fCtx, evt, fParams);
+
+			const double newFactor = knob->GetWeight(sigma, evt, fParams);
+			UpdateFactor(evtIdx, factors[i], newFactor);
+			factors[i] = newFactor;
+		}
+
+		if (++fNUpdates >= kMaxUpdates)
+			Rebuild();
+	}
+
+	// --------------------------------------
+	void WeightedSample::SetSigmas(const std::vector<double> & sigmas)
+	{
+		if (sigmas.size() != fKnobs.size())
+			throw std::runtime_error("NOvARwgt: WeightedSample::SetSigmas() got " + std::to_string(sigmas.size())
+			                         + " sigma values for " + std::to_string(fKnobs.size()) + " knobs");
+
+		for (std::size_t knobIdx = 0; knobIdx < sigmas.size(); knobIdx++)
+			SetSigma(knobIdx, sigmas[knobIdx]);
+	}
+
+	// --------------------------------------
+	double WeightedSample::Weight(std::size_t evtIdx) const
+	{
+		// a zero factor zeroes the whole weight; non-finite ones are treated the same way
+		// so that one bad knob can't poison a fit with NaNs
+		if (fNBad[evtIdx] > 0)
+			return 0;
+		return fCVWgts[evtIdx] * fProducts[evtIdx];
+	}
+
+	// --------------------------------------
+	void WeightedSample::Weights(std::vector<double> & wgts) const
+	{
+		wgts.resize(size());
+		for (std::size_t evtIdx = 0; evtIdx < size(); evtIdx++)
+			wgts[evtIdx] = Weight(evtIdx);
+	}
+
+	// --------------------------------------
+	void WeightedSample::UpdateFactor(std::size_t evtIdx, double oldFactor, double newFactor)
+	{
+		// bad factors were never multiplied in, so they come out of the count instead of the product
+		if (IsGood(oldFactor))
+			fProducts[evtIdx] /= oldFactor;
+		else
+			fNBad[evtIdx]--;
+
+		if (IsGood(newFactor))
+			fProducts[evtIdx] *= newFactor;
+		else
+			fNBad[evtIdx]++;
+	}
+
+	// --------------------------------------
+	void WeightedSample::Rebuild()
+	{
+		std::fill(fProducts.begin(), fProducts.end(), 1.);
+		std::fill(fNBad.begin(), fNBad.end(), 0);
+
+		for (std::size_t knobIdx = 0; knobIdx < fKnobs.size(); knobIdx++)
+		{
+			const auto & affected = fAffected[knobIdx];
+			const auto & factors = fFactors[knobIdx];
+			for (std::size_t i = 0; i < affected.size(); i++)
+			{
+				if (IsGood(factors[i]))
+					fProducts[affected[i]] *= factors[i];
+				else
+					fNBad[affected[i]]++;
+			}
+		}
+
+		fNUpdates = 0;
+	}
+}
@@ -21,15 +21,31 @@ namespace novarwgt
 
 	//----------------------------------------------------------------------
 
-	double SimpleRadiativeCorrNueXSecSyst::CalcWeight(double sigma, const novarwgt::EventRecord &ev,
-	                                                            const novarwgt::InputVals &) const
+	double SimpleRadiativeCorrNueXSecSyst::Slope(const novarwgt::EventRecord &ev) const
 	{
 		if (!ev.isCC)
-			return 1.0;
+			return 0;
 		if ( (!fIsNueBar && ev.nupdg != 12) || (fIsNueBar && ev.nupdg != -12) )
-			return 1.0;
+			return 0;
 
-		return 1 + .02*sigma;
+		return .02;
+	}
+
+	//----------------------------------------------------------------------
+
+	double SimpleRadiativeCorrNueXSecSyst::CalcWeight(double sigma, const novarwgt::EventRecord &ev,
+	                                                            const novarwgt::InputVals &) const
+	{
+		return 1 + Slope(ev)*sigma;
+	}
+
+	//----------------------------------------------------------------------
+
+	WeightAndDerivative SimpleRadiativeCorrNueXSecSyst::CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev,
+	                                                                            const novarwgt::InputVals &) const
+	{
+		const double slope = Slope(ev);
+		return {1 + slope*sigma, slope};
 	}
 
 	//----------------------------------------------------------------------
@@ -17,15 +17,29 @@ namespace novarwgt
 
 	//----------------------------------------------------------------------
 
-	double COHNormSyst2018::CalcWeight(double sigma, const novarwgt::EventRecord &ev, const InputVals &) const
+	double COHNormSyst2018::Slope(const novarwgt::EventRecord &ev) const
 	{
-		double wgt = 1.0;
 		if (ev.reaction != novarwgt::kScCoherent)
-			return wgt;
+			return 0;
 		if ((fIsCC && !ev.isCC) || (!fIsCC && ev.isCC))
-			return wgt;
+			return 0;
+
+		return 0.2;
+	}
+
+	//----------------------------------------------------------------------
+
+	double COHNormSyst2018::CalcWeight(double sigma, const novarwgt::EventRecord &ev, const InputVals &) const
+	{
+		return 1 + sigma * Slope(ev);
+	}
 
-		return 1 + sigma * 0.2;
+	//----------------------------------------------------------------------
+
+	WeightAndDerivative COHNormSyst2018::CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const InputVals &) const
+	{
+		const double slope = Slope(ev);
+		return {1 + sigma * slope, slope};
 	}
 
 }
\ No newline at end of file
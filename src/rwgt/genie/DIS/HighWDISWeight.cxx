@@ -20,15 +20,10 @@ namespace novarwgt
 
 	double HighWDISWgt_2018::CalcWeight(const novarwgt::EventRecord& ev, const novarwgt::InputVals&) const
 	{
-		bool isDIS    = ev.reaction == novarwgt::kScDeepInelastic;
-		bool isAntiNu = ev.nupdg < 0;
-		double W      = ev.W;
+		const std::uint32_t cls = ev.Classification();
 
-		// a few NOvA records are bonkers
-		if ( W < 0 || std::isnan(W) )
-			return 1.;
-
-		if ( !isDIS || isAntiNu || W < 1.7 ) return 1.;
+		// (a few NOvA records are bonkers, with W < 0 or NaN; kEvtHighW isn't set for those)
+		if ( (cls & (kEvtDIS | kEvtHighW)) != (kEvtDIS | kEvtHighW) || (cls & kEvtNubar) ) return 1.;
 
 		return 1.1;
 	}
@@ -24,15 +24,15 @@ namespace novarwgt
 	{
 		// todo: if we're going to exclude nubars, we should probably also exclude NC?...
 
-		if (ev.reaction != novarwgt::kScDeepInelastic)
-			return 1.;
-		// a very few NOvA records are bonkers, hence the NaN checks
-		if (ev.W > 1.7 || ev.W < 0 || std::isnan(ev.W))
+		const std::uint32_t cls = ev.Classification();
+
+		// a very few NOvA records are bonkers (W < 0 or NaN); kEvtLowW isn't set for those
+		if ((cls & (kEvtDIS | kEvtLowW)) != (kEvtDIS | kEvtLowW))
 			return 1.;
 
 		// note that Rodrigues et al. only worked with neutrino scattering--
 		// nothing is said about antineutrinos
-		if (ev.nupdg < 0)
+		if (cls & kEvtNubar)
 			return 1.;
 
 		// older versions of this weight used an approximate version that scaled ALL nonres pi prod with W < 1.7
@@ -40,7 +40,7 @@ namespace novarwgt
 		if (fUseApproxCut)
 			return 0.65;
 
-		if (ev.npiplus + ev.npizero + ev.npiminus != 1)
+		if (!(cls & kEvt1Pi))
 			return 1.;
 
 		if (fUseTypoWeight)
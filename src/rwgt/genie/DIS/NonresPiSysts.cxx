@@ -54,30 +54,113 @@ namespace novarwgt
 	
 	//----------------------------------------------------------------------
 
-	double DISnPionSyst::CalcWeight(double sigma, const novarwgt::EventRecord &ev, const InputVals &) const
+	constexpr int DISnPionSyst::kNSlots;
+
+	//----------------------------------------------------------------------
+
+	int DISnPionSyst::EventSlot(const novarwgt::EventRecord &ev)
 	{
-		double wgt = 1.0;
-		if(ev.reaction != novarwgt::kScDeepInelastic) return wgt;
+		const std::uint32_t cls = ev.Classification();
+		if( !(cls & kEvtDIS) ) return ISystKnobFamily::kNoSlot;
+		if( !(cls & (kEvtStruckProton | kEvtStruckNeutron)) ) return ISystKnobFamily::kNoSlot; // only proton or neutron
 
 		// note that the knob variants handle 0, 1, 2, 3+ pions
 		// (where the last one handles 3 or more)
 		unsigned int npion = ev.npiplus + ev.npizero + ev.npiminus;
-		if( fNPion < 3 && npion != fNPion ) return wgt;
-		if( fNPion == 3 && npion < fNPion ) return wgt;
+		if (npion > 3)
+			npion = 3;
+
+		return SlotIndex(npion, cls & kEvtNubar, cls & kEvtCC, cls & kEvtStruckProton);
+	}
 
-		if(ev.nupdg > 0 && fIsAntiNu) return wgt;
-		if(ev.nupdg < 0 && !fIsAntiNu) return wgt;
-		if(ev.isCC != fIsCC) return wgt;
+	//----------------------------------------------------------------------
+
+	double DISnPionSyst::Slope(const novarwgt::EventRecord &ev) const
+	{
+		if (EventSlot(ev) != fSlot)
+			return 0;
+		return SlotSlope(ev);
+	}
 
-		if( !( ev.struckNucl == 2212 || ev.struckNucl == 2112 ) ) return wgt; // only proton or neutron
-		if( ev.struckNucl == 2212 && !fStruckProton ) return wgt;
-		if( ev.struckNucl == 2112 && fStruckProton ) return wgt;
+	//----------------------------------------------------------------------
 
+	double DISnPionSyst::SlotSlope(const novarwgt::EventRecord &ev) const
+	{
 		// 1 sigma is 50% variation
-		wgt = 1 + fSystVarLowW * sigma;
-		if (ev.W*ev.W > fWcut*fWcut)
-			wgt = 1 + fSystVarHighW*sigma; // only 5% variation above W = 3 GeV/c^2
+		if (ev.W2() > fWcut*fWcut)
+			return fSystVarHighW; // only 5% variation above W = 3 GeV/c^2
+		return fSystVarLowW;
+	}
+
+	//----------------------------------------------------------------------
+
+	double DISnPionSyst::CalcWeight(double sigma, const novarwgt::EventRecord &ev, const InputVals &) const
+	{
+		return 1 + Slope(ev) * sigma;
+	}
+
+	//----------------------------------------------------------------------
+
+	WeightAndDerivative DISnPionSyst::CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const InputVals &) const
+	{
+		const double slope = Slope(ev);
+		return {1 + slope * sigma, slope};
+	}
 
-		return wgt;
+	//----------------------------------------------------------------------
+
+	const ISystKnobFamily * DISnPionSyst::Family() const
+	{
+		// only the standard instances are members
+		const auto & family = GetDISnPionSystFamily();
+		return (family.Members()[fSlot] == this) ? &family : nullptr;
+	}
+
+	//----------------------------------------------------------------------
+
+	DISnPionSystFamily::DISnPionSystFamily()
+	{
+		fMembers.resize(DISnPionSyst::kNSlots);
+		for (bool isAntiNu : {false, true})
+		{
+			for (bool struckProton : {true, false})
+			{
+				for (bool isCC : {true, false})
+				{
+					// n.b.: argument types must match the declarations above exactly, or the registry makes new knobs
+					for (int nPion = 0; nPion <= 3; nPion++)
+						fMembers[DISnPionSyst::SlotIndex(nPion, isAntiNu, isCC, struckProton)]
+							= GetSystKnob<novarwgt::DISnPionSyst>(nPion, isAntiNu, isCC, struckProton);
+				}
+			}
+		}
+	}
+
+	//----------------------------------------------------------------------
+
+	void DISnPionSystFamily::TestIfEvtGenIsSupported(const novarwgt::EventRecord &ev, const InputVals &params) const
+	{
+		if (ev.expectNoWeights)
+			return;
+		fMembers.front()->TestIfEvtGenIsSupported(ev, params);
+	}
+
+	//----------------------------------------------------------------------
+
+	double DISnPionSystFamily::SlotWeight(int slot, double sigma, const novarwgt::EventRecord &ev, const InputVals &) const
+	{
+		if (ev.expectNoWeights)
+			return 1.0;
+
+		const auto knob = static_cast<const DISnPionSyst*>(fMembers[slot]);
+		return knob->Clamp(1 + knob->SlotSlope(ev) * sigma);
+	}
+
+	//----------------------------------------------------------------------
+
+	const DISnPionSystFamily & GetDISnPionSystFamily()
+	{
+		static const DISnPionSystFamily family;
+		return family;
 	}
-}
\ No newline at end of file
+}
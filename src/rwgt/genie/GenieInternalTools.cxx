@@ -6,6 +6,12 @@
  *      Author: J. Wolcott <jwolcott@fnal.gov>
  */
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+
 #include "GenieInternalTools.h"
 
 // if we weren't built against GENIE, nothing to see here
@@ -18,7 +24,22 @@
 #include "Framework/EventGen/XSecAlgorithmI.h"
 #include "Framework/GHEP/GHepParticle.h"
 #include "Framework/Utils/XSecSplineList.h"
+#include "RwCalculators/GReWeightAGKY.h"
+#include "RwCalculators/GReWeightDISNuclMod.h"
+#include "RwCalculators/GReWeightFGM.h"
+#include "RwCalculators/GReWeightFZone.h"
+#include "RwCalculators/GReWeightINuke.h"
+#include "RwCalculators/GReWeightNonResonanceBkg.h"
 #include "RwCalculators/GReWeightNuXSecCCQE.h"
+#include "RwCalculators/GReWeightNuXSecCCQEaxial.h"
+#include "RwCalculators/GReWeightNuXSecCCQEvec.h"
+#include "RwCalculators/GReWeightNuXSecCCRES.h"
+#include "RwCalculators/GReWeightNuXSecCOH.h"
+#include "RwCalculators/GReWeightNuXSecDIS.h"
+#include "RwCalculators/GReWeightNuXSecNC.h"
+#include "RwCalculators/GReWeightNuXSecNCEL.h"
+#include "RwCalculators/GReWeightNuXSecNCRES.h"
+#include "RwCalculators/GReWeightResonanceDecay.h"
 #include "RwFramework/GSystUncertainty.h"
 #else
 #include "Algorithm/AlgFactory.h"
@@ -29,7 +50,22 @@
 #include "GHEP/GHepParticle.h"
 #include "ReWeight/GSystUncertainty.h"
 #include "ReWeight/GReWeight.h"
+#include "ReWeight/GReWeightAGKY.h"
+#include "ReWeight/GReWeightDISNuclMod.h"
+#include "ReWeight/GReWeightFGM.h"
+#include "ReWeight/GReWeightFZone.h"
+#include "ReWeight/GReWeightINuke.h"
+#include "ReWeight/GReWeightNonResonanceBkg.h"
 #include "ReWeight/GReWeightNuXSecCCQE.h"
+#include "ReWeight/GReWeightNuXSecCCQEaxial.h"
+#include "ReWeight/GReWeightNuXSecCCQEvec.h"
+#include "ReWeight/GReWeightNuXSecCCRES.h"
+#include "ReWeight/GReWeightNuXSecCOH.h"
+#include "ReWeight/GReWeightNuXSecDIS.h"
+#include "ReWeight/GReWeightNuXSecNC.h"
+#include "ReWeight/GReWeightNuXSecNCEL.h"
+#include "ReWeight/GReWeightNuXSecNCRES.h"
+#include "ReWeight/GReWeightResonanceDecay.h"
 #endif
 
 #include "NOvARwgt/rwgt/EventRecord.h"
@@ -40,35 +76,392 @@ namespace novarwgt
 {
 	namespace internal
 	{
+		// anonymous namespace since it shouldn't be in the interface
+		namespace
+		{
+			/// Setting up a calculator touches GENIE singletons (GSystUncertainty, AlgFactory, ...),
+			/// which aren't thread-safe, so only one thread at a time gets to do it
+			std::mutex gCalcSetupMutex;
+
+			/// The CC-QE cross section model used for synthetic GENIE records.
+			/// Configuring one is expensive, so each thread makes just one
+			/// (adopted rather than shared, since GENIE algorithms aren't thread-safe) and keeps it.
+			const genie::XSecAlgorithmI * ThreadLocalQELXSecModel()
+			{
+				thread_local std::unique_ptr<genie::XSecAlgorithmI> model;
+				if (model)
+					return model.get();
 
+				std::lock_guard<std::mutex> lock(gCalcSetupMutex);
 #if GENIE_MAJOR_VERSION >= 3
-		genie::rew::GReWeightModel* ReweightObjWrapper::GetWeighter(genie::rew::GSyst_t knobType) const
+				genie::AlgConfigPool * conf_pool = genie::AlgConfigPool::Instance();
+				genie::Registry * gpl = conf_pool->GlobalParameterList();
+				RgAlg xsec_alg = gpl->GetAlg("XSecModel@genie::EventGenerator/QEL-CC");
+				genie::AlgId id(xsec_alg);
 #else
-		genie::rew::GReWeightI* ReweightObjWrapper::GetWeighter(genie::rew::GSyst_t knobType) const
+				genie::AlgId id("genie::LwlynSmithQELCCPXSec", "Default");
+#endif
+				genie::Algorithm * alg = genie::AlgFactory::Instance()->AdoptAlgorithm(id);
+				model.reset(dynamic_cast<genie::XSecAlgorithmI *>(alg));
+				if (!model)
+				{
+					delete alg;
+					throw std::runtime_error("NOvARwgt: couldn't load GENIE CC-QE cross section model '" + id.Key() + "'");
+				}
+
+				return model.get();
+			}
+
+			/// The parts of a novarwgt::EventRecord that go into the synthetic GENIE record made by ToGenieEvent()
+			struct SyntheticGenieEvtKey
+			{
+				SyntheticGenieEvtKey() = default;
+
+				explicit SyntheticGenieEvtKey(const novarwgt::EventRecord & rec)
+					: nupdg(rec.nupdg), isCC(rec.isCC), reaction(rec.reaction), struckNucl(rec.struckNucl),
+					  A(rec.A), Enu(rec.Enu), q(rec.q), W(rec.W), y(rec.y),
+					  npiplus(rec.npiplus), npizero(rec.npizero), npiminus(rec.npiminus)
+				{}
+
+				bool operator==(const SyntheticGenieEvtKey & other) const
+				{
+					// unset kinematics are NaN, which mustn't spoil the comparison
+					auto same = [](double a, double b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+					return nupdg == other.nupdg && isCC == other.isCC && reaction == other.reaction
+					       && struckNucl == other.struckNucl && A == other.A
+					       && same(Enu, other.Enu) && same(W, other.W) && same(y, other.y)
+					       && same(q.Px(), other.q.Px()) && same(q.Py(), other.q.Py())
+					       && same(q.Pz(), other.q.Pz()) && same(q.E(), other.q.E())
+					       && npiplus == other.npiplus && npizero == other.npizero && npiminus == other.npiminus;
+				}
+
+				int nupdg;
+				bool isCC;
+				novarwgt::ReactionType reaction;
+				int struckNucl;
+				unsigned int A;
+				double Enu;
+				TLorentzVector q;
+				double W;
+				double y;
+				int npiplus;
+				int npizero;
+				int npiminus;
+			};
+		}
+
+		ReweightObjWrapper::CalcKind ReweightObjWrapper::KindForKnob(genie::rew::GSyst_t knob)
+		{
+			switch (knob)
+			{
+				case genie::rew::kXSecTwkDial_MaCCQE:
+					return kCalcCCQEMa;
+
+				case genie::rew::kXSecTwkDial_NormCCQE:
+				case genie::rew::kXSecTwkDial_NormCCQEenu:
+				case genie::rew::kXSecTwkDial_MaCCQEshape:
+					return kCalcCCQEShape;
+
+				case genie::rew::kXSecTwkDial_ZNormCCQE:
+				case genie::rew::kXSecTwkDial_ZExpA1CCQE:
+				case genie::rew::kXSecTwkDial_ZExpA2CCQE:
+				case genie::rew::kXSecTwkDial_ZExpA3CCQE:
+				case genie::rew::kXSecTwkDial_ZExpA4CCQE:
+					return kCalcCCQEZExp;
+
+				case genie::rew::kXSecTwkDial_AxFFCCQEshape:
+					return kCalcCCQEAxial;
+
+				case genie::rew::kXSecTwkDial_VecFFCCQEshape:
+					return kCalcCCQEVec;
+
+				case genie::rew::kXSecTwkDial_MaCCRES:
+				case genie::rew::kXSecTwkDial_MvCCRES:
+					return kCalcCCRESMaMv;
+
+				case genie::rew::kXSecTwkDial_NormCCRES:
+				case genie::rew::kXSecTwkDial_MaCCRESshape:
+				case genie::rew::kXSecTwkDial_MvCCRESshape:
+					return kCalcCCRESShape;
+
+				case genie::rew::kXSecTwkDial_MaNCRES:
+				case genie::rew::kXSecTwkDial_MvNCRES:
+					return kCalcNCRESMaMv;
+
+				case genie::rew::kXSecTwkDial_NormNCRES:
+				case genie::rew::kXSecTwkDial_MaNCRESshape:
+				case genie::rew::kXSecTwkDial_MvNCRESshape:
+					return kCalcNCRESShape;
+
+				case genie::rew::kXSecTwkDial_MaCOHpi:
+				case genie::rew::kXSecTwkDial_R0COHpi:
+					return kCalcCOH;
+
+				case genie::rew::kXSecTwkDial_RvpCC1pi:
+				case genie::rew::kXSecTwkDial_RvpCC2pi:
+				case genie::rew::kXSecTwkDial_RvpNC1pi:
+				case genie::rew::kXSecTwkDial_RvpNC2pi:
+				case genie::rew::kXSecTwkDial_RvnCC1pi:
+				case genie::rew::kXSecTwkDial_RvnCC2pi:
+				case genie::rew::kXSecTwkDial_RvnNC1pi:
+				case genie::rew::kXSecTwkDial_RvnNC2pi:
+				case genie::rew::kXSecTwkDial_RvbarpCC1pi:
+				case genie::rew::kXSecTwkDial_RvbarpCC2pi:
+				case genie::rew::kXSecTwkDial_RvbarpNC1pi:
+				case genie::rew::kXSecTwkDial_RvbarpNC2pi:
+				case genie::rew::kXSecTwkDial_RvbarnCC1pi:
+				case genie::rew::kXSecTwkDial_RvbarnCC2pi:
+				case genie::rew::kXSecTwkDial_RvbarnNC1pi:
+				case genie::rew::kXSecTwkDial_RvbarnNC2pi:
+					return kCalcNonResBkg;
+
+				case genie::rew::kXSecTwkDial_AhtBY:
+				case genie::rew::kXSecTwkDial_BhtBY:
+				case genie::rew::kXSecTwkDial_CV1uBY:
+				case genie::rew::kXSecTwkDial_CV2uBY:
+				case genie::rew::kXSecTwkDial_NormDISCC:
+				case genie::rew::kXSecTwkDial_RnubarnuCC:
+					return kCalcDIS;
+
+				case genie::rew::kXSecTwkDial_AhtBYshape:
+				case genie::rew::kXSecTwkDial_BhtBYshape:
+				case genie::rew::kXSecTwkDial_CV1uBYshape:
+				case genie::rew::kXSecTwkDial_CV2uBYshape:
+					return kCalcDISShape;
+
+				case genie::rew::kXSecTwkDial_DISNuclMod:
+					return kCalcDISNuclMod;
+
+				case genie::rew::kXSecTwkDial_MaNCEL:
+				case genie::rew::kXSecTwkDial_EtaNCEL:
+					return kCalcNCEL;
+
+				case genie::rew::kXSecTwkDial_NC:
+					return kCalcNC;
+
+				case genie::rew::kHadrAGKYTwkDial_xF1pi:
+				case genie::rew::kHadrAGKYTwkDial_pT1pi:
+					return kCalcAGKY;
+
+				case genie::rew::kHadrNuclTwkDial_FormZone:
+					return kCalcFZone;
+
+				case genie::rew::kINukeTwkDial_MFP_pi:
+				case genie::rew::kINukeTwkDial_MFP_N:
+				case genie::rew::kINukeTwkDial_FrCEx_pi:
+#if GENIE_MAJOR_VERSION < 3
+				case genie::rew::kINukeTwkDial_FrElas_pi:
+#endif
+				case genie::rew::kINukeTwkDial_FrInel_pi:
+				case genie::rew::kINukeTwkDial_FrAbs_pi:
+				case genie::rew::kINukeTwkDial_FrPiProd_pi:
+				case genie::rew::kINukeTwkDial_FrCEx_N:
+#if GENIE_MAJOR_VERSION < 3
+				case genie::rew::kINukeTwkDial_FrElas_N:
 #endif
+				case genie::rew::kINukeTwkDial_FrInel_N:
+				case genie::rew::kINukeTwkDial_FrAbs_N:
+				case genie::rew::kINukeTwkDial_FrPiProd_N:
+					return kCalcINuke;
+
+				case genie::rew::kSystNucl_CCQEPauliSupViaKF:
+				case genie::rew::kSystNucl_CCQEMomDistroFGtoSF:
+					return kCalcFGM;
+
+				case genie::rew::kRDcyTwkDial_BR1gamma:
+				case genie::rew::kRDcyTwkDial_BR1eta:
+				case genie::rew::kRDcyTwkDial_Theta_Delta2Npi:
+					return kCalcResDecay;
+
+				default:
+					throw std::runtime_error("NOvARwgt: Requesting GENIE reweight for unhandled knob: " + genie::rew::GSyst::AsString(knob));
+			}
+		}
+
+		//----------------------------------------------------------------------------
+
+		ReweightObjWrapper::Calc_t * ReweightObjWrapper::GetWeighter(CalcKind kind) const
+		{
+			if (fCalcs.empty())
+				fCalcs.resize(kNumCalcKinds);
+			if (fCalcs[kind])
+				return fCalcs[kind].get();
+
+			std::lock_guard<std::mutex> lock(gCalcSetupMutex);
+
+			std::unique_ptr<Calc_t> calc;
+			switch (kind)
+			{
+				case kCalcCCQEMa:
+				case kCalcCCQEShape:
+				case kCalcCCQEZExp:
+				{
+					auto ccqe = std::make_unique<genie::rew::GReWeightNuXSecCCQE>();
+					if (kind == kCalcCCQEMa)
+					{
+						// for now, force this to go back to the old 2.12.X error budget.
+						// todo: what if the CV isn't what we're expecting?
+						genie::rew::GSystUncertainty::Instance()->SetUncertainty(genie::rew::kXSecTwkDial_MaCCQE, 0.25, 0.15);
+						ccqe->SetMode(genie::rew::GReWeightNuXSecCCQE::kModeMa);
+					}
+					else if (kind == kCalcCCQEShape)
+						ccqe->SetMode(genie::rew::GReWeightNuXSecCCQE::kModeNormAndMaShape);
+					else
+						ccqe->SetMode(genie::rew::GReWeightNuXSecCCQE::kModeZExp);
+					calc = std::move(ccqe);
+					break;
+				}
+
+				case kCalcCCQEAxial:
+					calc = std::make_unique<genie::rew::GReWeightNuXSecCCQEaxial>();
+					break;
+
+				case kCalcCCQEVec:
+					calc = std::make_unique<genie::rew::GReWeightNuXSecCCQEvec>();
+					break;
+
+				case kCalcCCRESMaMv:
+				case kCalcCCRESShape:
+				{
+					auto res = std::make_unique<genie::rew::GReWeightNuXSecCCRES>();
+					res->SetMode(kind == kCalcCCRESMaMv ? genie::rew::GReWeightNuXSecCCRES::kModeMaMv
+					                                    : genie::rew::GReWeightNuXSecCCRES::kModeNormAndMaMvShape);
+					calc = std::move(res);
+					break;
+				}
+
+				case kCalcNCRESMaMv:
+				case kCalcNCRESShape:
+				{
+					auto res = std::make_unique<genie::rew::GReWeightNuXSecNCRES>();
+					res->SetMode(kind == kCalcNCRESMaMv ? genie::rew::GReWeightNuXSecNCRES::kModeMaMv
+					                                    : genie::rew::GReWeightNuXSecNCRES::kModeNormAndMaMvShape);
+					calc = std::move(res);
+					break;
+				}
+
+				case kCalcCOH:
+					calc = std::make_unique<genie::rew::GReWeightNuXSecCOH>();
+					break;
+
+				case kCalcNonResBkg:
+					calc = std::make_unique<genie::rew::GReWeightNonResonanceBkg>();
+					break;
+
+				case kCalcDIS:
+				case kCalcDISShape:
+				{
+					auto dis = std::make_unique<genie::rew::GReWeightNuXSecDIS>();
+					dis->SetMode(kind == kCalcDIS ? genie::rew::GReWeightNuXSecDIS::kModeABCV12u
+					                              : genie::rew::GReWeightNuXSecDIS::kModeABCV12uShape);
+					calc = std::move(dis);
+					break;
+				}
+
+				case kCalcDISNuclMod:
+					calc = std::make_unique<genie::rew::GReWeightDISNuclMod>();
+					break;
+
+				case kCalcNCEL:
+					calc = std::make_unique<genie::rew::GReWeightNuXSecNCEL>();
+					break;
+
+				case kCalcNC:
+					calc = std::make_unique<genie::rew::GReWeightNuXSecNC>();
+					break;
+
+				case kCalcAGKY:
+					calc = std::make_unique<genie::rew::GReWeightAGKY>();
+					break;
+
+				case kCalcFZone:
+					calc = std::make_unique<genie::rew::GReWeightFZone>();
+					break;
+
+				case kCalcINuke:
+					calc = std::make_unique<genie::rew::GReWeightINuke>();
+					break;
+
+				case kCalcFGM:
+					calc = std::make_unique<genie::rew::GReWeightFGM>();
+					break;
+
+				case kCalcResDecay:
+					calc = std::make_unique<genie::rew::GReWeightResonanceDecay>();
+					break;
+
+				default:
+					throw std::runtime_error("NOvARwgt: unknown GENIE calculator type: " + std::to_string(kind));
+			}
+
+			fCalcs[kind] = std::move(calc);
+			return fCalcs[kind].get();
+		}
+
+		//----------------------------------------------------------------------------
+
+		void ReweightObjWrapper::Configure(CalcKind kind, const std::vector<std::pair<genie::rew::GSyst_t, double>> & knobSigmas) const
 		{
-			auto knobPair = fCalcs.find(knobType);
-			if (knobPair != fCalcs.end())
-				return knobPair->second.get();
+			auto calc = GetWeighter(kind);
+			if (fCurrentSigmas.empty())
+				fCurrentSigmas.resize(kNumCalcKinds);
+			auto & currentSigmas = fCurrentSigmas[kind];
+			bool changed = false;
+
+			// anything else this calculator was tweaking goes back to nominal
+			for (auto & sigmaPair : currentSigmas)
+			{
+				if (sigmaPair.second == 0)
+					continue;
+				if (std::any_of(knobSigmas.begin(), knobSigmas.end(),
+				                [&sigmaPair](const std::pair<genie::rew::GSyst_t, double> & ks) { return ks.first == sigmaPair.first; }))
+					continue;
+
+				calc->SetSystematic(sigmaPair.first, 0);
+				sigmaPair.second = 0;
+				changed = true;
+			}
 
-			// add more as needed
-			if (knobType == genie::rew::kXSecTwkDial_MaCCQE)
+			for (const auto & knobSigma : knobSigmas)
 			{
-				// for now, force this to go back to the old 2.12.X error budget.
-				// todo: what if the CV isn't what we're expecting?
-				genie::rew::GSystUncertainty::Instance()->SetUncertainty(genie::rew::kXSecTwkDial_MaCCQE, 0.25, 0.15);
-				fCalcs[knobType] = std::make_unique<genie::rew::GReWeightNuXSecCCQE>();
-				auto knob = dynamic_cast<genie::rew::GReWeightNuXSecCCQE*>(fCalcs.at(knobType).get());
-				knob->SetMode(genie::rew::GReWeightNuXSecCCQE::kModeMa);
-				knob->SetSystematic(genie::rew::kXSecTwkDial_MaCCQE, +1);  // this is the only one we need right now...
-				knob->Reconfigure();
+				auto sigmaIt = std::find_if(currentSigmas.begin(), currentSigmas.end(),
+				                            [&knobSigma](const std::pair<genie::rew::GSyst_t, double> & cs) { return cs.first == knobSigma.first; });
+				if (sigmaIt == currentSigmas.end())
+				{
+					// first time we've seen this knob
+					if (!calc->IsHandled(knobSigma.first))
+						throw std::runtime_error("NOvARwgt: GENIE calculator doesn't handle knob: " + genie::rew::GSyst::AsString(knobSigma.first));
+					currentSigmas.emplace_back(knobSigma.first, 0.);
+					sigmaIt = std::prev(currentSigmas.end());
+				}
+				if (sigmaIt->second == knobSigma.second)
+					continue;
+
+				calc->SetSystematic(knobSigma.first, knobSigma.second);
+				sigmaIt->second = knobSigma.second;
+				changed = true;
 			}
-			else
-				throw std::runtime_error("GenieInterface.cxx: Requesting GENIE reweight for unhandled knob:" + GetGenieKnobName(ConvertGenieKnob(knobType)));
 
-			return fCalcs.at(knobType).get();
+			if (changed)
+				calc->Reconfigure();
 		}
 
+		//----------------------------------------------------------------------------
+
+		bool ReweightObjWrapper::NeedsHadronicSystem(genie::rew::GSyst_t knob)
+		{
+			switch (KindForKnob(knob))
+			{
+				case kCalcAGKY:
+				case kCalcFZone:
+				case kCalcINuke:
+				case kCalcResDecay:
+					return true;
+
+				default:
+					return false;
+			}
+		}
 
 		//----------------------------------------------------------------------------
 
@@ -93,9 +486,100 @@ namespace novarwgt
 
 		double ReweightObjWrapper::GetWeight(const genie::EventRecord *ev, genie::rew::GSyst_t knob, double sigma) const
 		{
-			auto wgtr = GetWeighter(knob);
-			wgtr->SetSystematic(knob, sigma);
-			return wgtr->CalcWeight(*ev);
+			const CalcKind kind = KindForKnob(knob);
+			Configure(kind, {{knob, sigma}});
+			return GetWeighter(kind)->CalcWeight(*ev);
+		}
+
+		//----------------------------------------------------------------------------
+
+		double ReweightObjWrapper::GetWeight(const genie::EventRecord *ev, const std::vector<std::pair<genie::rew::GSyst_t, double>> & knobSigmas) const
+		{
+			// each calculator gets all of its knobs at once, then is called once
+			std::vector<std::pair<genie::rew::GSyst_t, double>> calcKnobs;
+			std::vector<bool> done(knobSigmas.size(), false);
+			double wgt = 1;
+			for (std::size_t idx = 0; idx < knobSigmas.size(); idx++)
+			{
+				if (done[idx])
+					continue;
+
+				const CalcKind kind = KindForKnob(knobSigmas[idx].first);
+				calcKnobs.clear();
+				for (std::size_t otherIdx = idx; otherIdx < knobSigmas.size(); otherIdx++)
+				{
+					if (done[otherIdx] || KindForKnob(knobSigmas[otherIdx].first) != kind)
+						continue;
+					calcKnobs.push_back(knobSigmas[otherIdx]);
+					done[otherIdx] = true;
+				}
+
+				Configure(kind, calcKnobs);
+				wgt *= GetWeighter(kind)->CalcWeight(*ev);
+			}
+
+			return wgt;
+		}
+
+		//----------------------------------------------------------------------------
+
+		void ReweightObjWrapper::GetWeights(const std::vector<const genie::EventRecord*> & evs,
+		                                    genie::rew::GSyst_t knob,
+		                                    const std::vector<double> & sigmas,
+		                                    std::vector<double> & wgts) const
+		{
+			wgts.resize(sigmas.size() * evs.size());
+			const CalcKind kind = KindForKnob(knob);
+			auto wgtr = GetWeighter(kind);
+			for (std::size_t sigmaIdx = 0; sigmaIdx < sigmas.size(); sigmaIdx++)
+			{
+				Configure(kind, {{knob, sigmas[sigmaIdx]}});
+				const std::size_t offset = sigmaIdx * evs.size();
+				for (std::size_t evIdx = 0; evIdx < evs.size(); evIdx++)
+					wgts[offset + evIdx] = wgtr->CalcWeight(*evs[evIdx]);
+			}
+		}
+
+		//----------------------------------------------------------------------------
+
+		void ReweightObjWrapper::GetWeightTables(const std::vector<const genie::EventRecord*> & evs,
+		                                         const std::vector<genie::rew::GSyst_t> & knobs,
+		                                         std::vector<novarwgt::ReweightVals> & tables) const
+		{
+			tables.resize(knobs.size() * evs.size());
+
+			// process the knobs grouped by calculator,
+			// so that moving to the next knob only means one reconfiguration of the same calculator
+			std::vector<std::size_t> knobOrder(knobs.size());
+			std::iota(knobOrder.begin(), knobOrder.end(), 0);
+			std::stable_sort(knobOrder.begin(), knobOrder.end(),
+			                 [&knobs](std::size_t a, std::size_t b) { return KindForKnob(knobs[a]) < KindForKnob(knobs[b]); });
+
+			static const double sigmas[] = {-2, -1, +1, +2};
+			static float novarwgt::ReweightVals::* const members[] = { &novarwgt::ReweightVals::minus2sigma,
+			                                                          &novarwgt::ReweightVals::minus1sigma,
+			                                                          &novarwgt::ReweightVals::plus1sigma,
+			                                                          &novarwgt::ReweightVals::plus2sigma };
+			for (const auto knobIdx : knobOrder)
+			{
+				const CalcKind kind = KindForKnob(knobs[knobIdx]);
+				auto wgtr = GetWeighter(kind);
+				const std::size_t offset = knobIdx * evs.size();
+				for (std::size_t sigmaIdx = 0; sigmaIdx < 4; sigmaIdx++)
+				{
+					Configure(kind, {{knobs[knobIdx], sigmas[sigmaIdx]}});
+					for (std::size_t evIdx = 0; evIdx < evs.size(); evIdx++)
+						tables[offset + evIdx].*members[sigmaIdx] = wgtr->CalcWeight(*evs[evIdx]);
+				}
+			}
+		}
+
+		//----------------------------------------------------------------------------
+
+		const ReweightObjWrapper & ThreadLocalRWCache()
+		{
+			thread_local const ReweightObjWrapper cache;
+			return cache;
 		}
 
 		//----------------------------------------------------------------------------
@@ -123,21 +607,10 @@ namespace novarwgt
 
 		//----------------------------------------------------------------------------
 
-		genie::EventRecord ToGenieEvent(const novarwgt::EventRecord &rec)
+		void ToGenieEvent(const novarwgt::EventRecord &rec, genie::EventRecord & evt)
 		{
-#if GENIE_MAJOR_VERSION >= 3
-
-			genie::AlgConfigPool * conf_pool = genie::AlgConfigPool::Instance();
-			genie::Registry * gpl = conf_pool->GlobalParameterList();
-			RgAlg xsec_alg = gpl->GetAlg("XSecModel@genie::EventGenerator/QEL-CC");
-			genie::AlgId id(xsec_alg);
-#else
-			genie::AlgId id("genie::LwlynSmithQELCCPXSec", "Default");
-#endif
-			genie::AlgFactory * algf = genie::AlgFactory::Instance();
-
-
-			genie::EventRecord evt;
+			// clears out the old contents but keeps the particle array's storage around
+			evt.ResetRecord();
 
 			// currently not saving Z <grimace>
 			genie::InitialState itlState(rec.A > 1 ? rec.A/2 : 1, rec.A, rec.nupdg);
@@ -195,11 +668,30 @@ namespace novarwgt
 				interaction->SetBit(genie::kISkipKinematicChk, true);
 				interaction->KinePtr()->UseSelectedKinematics();
 				interaction->SetBit(genie::kIAssumeFreeNucleon);
-				auto model = dynamic_cast<genie::XSecAlgorithmI *>(algf->AdoptAlgorithm(id));
-				double difflXsec = model->XSec(interaction, genie::kPSQ2fE);
+				double difflXsec = ThreadLocalQELXSecModel()->XSec(interaction, genie::kPSQ2fE);
 				evt.SetDiffXSec(difflXsec, genie::kPSQ2fE);
 			}
+		}
+
+		//----------------------------------------------------------------------------
 
+		const genie::EventRecord & ToGenieEvent(const novarwgt::EventRecord &rec)
+		{
+			thread_local genie::EventRecord evt;
+			thread_local SyntheticGenieEvtKey evtKey{};
+			thread_local bool evtKeyValid = false;
+
+			// when several GENIE knobs (or sigmas) are evaluated for the same event one after another,
+			// as Tune does, only the first one needs to build the record (and compute the cross section).
+			// the comparison is by content rather than address, since callers often refill the same EventRecord
+			SyntheticGenieEvtKey key(rec);
+			if (evtKeyValid && evtKey == key)
+				return evt;
+
+			evtKeyValid = false;   // in case ToGenieEvent() throws, don't leave a stale key behind
+			ToGenieEvent(rec, evt);
+			evtKey = key;
+			evtKeyValid = true;
 			return evt;
 		}
 
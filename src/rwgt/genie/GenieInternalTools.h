@@ -15,6 +15,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #if GENIE_MAJOR_VERSION >= 3
@@ -44,30 +45,103 @@ namespace novarwgt
 		/// Convert a NOvA knob enum into a GENIE one.
 		genie::rew::GSyst_t    ConvertToGenieKnob(novarwgt::ReweightKnob);
 
-		/// Wrapper that helps with caching of GENIE reweighters
+		/// Wrapper that helps with caching of GENIE reweighters.
+		///
+		/// Knobs are handled by the GENIE calculator class (and mode) responsible for them,
+		/// and knobs that share a calculator share the instance.
+		/// Whenever a calculator is used, any of its knobs that weren't asked for are reset to nominal.
+		///
+		/// The GENIE calculators are stateful (SetSystematic() + CalcWeight()),
+		/// so an instance must never be shared between threads.
+		/// Use ThreadLocalRWCache() to get the one belonging to the current thread.
 		class ReweightObjWrapper
 		{
 			public:
 				ReweightObjWrapper() = default;
 
 				double GetWeight(const genie::EventRecord *ev, genie::rew::GSyst_t knob, double sigma=1.0) const;
-			private:
 
-#if GENIE_MAJOR_VERSION >= 3
-				genie::rew::GReWeightModel* GetWeighter(genie::rew::GSyst_t knobType) const;
-#else
-				genie::rew::GReWeightI* GetWeighter(genie::rew::GSyst_t knobType) const;
-#endif
+				/// Joint weight for several knobs shifted at once.
+				/// Each calculator involved is configured with all of its knobs together and called once.
+				double GetWeight(const genie::EventRecord *ev, const std::vector<std::pair<genie::rew::GSyst_t, double>> & knobSigmas) const;
 
+				/// Compute weights for many events at many values of one knob.
+				/// Each sigma is set (and the calculator reconfigured) just once,
+				/// after which all the events are swept through.
+				/// \param wgts  Output, indexed as [sigma index * evs.size() + event index]
+				void GetWeights(const std::vector<const genie::EventRecord*> & evs,
+				                genie::rew::GSyst_t knob,
+				                const std::vector<double> & sigmas,
+				                std::vector<double> & wgts) const;
+
+				/// Compute the -2, -1, +1, +2 sigma weight tables for many events and knobs.
+				/// The knobs are processed grouped by calculator, and for each (knob, sigma)
+				/// the calculator is reconfigured just once before sweeping all the events.
+				/// \param tables  Output, indexed as [knob index * evs.size() + event index]
+				void GetWeightTables(const std::vector<const genie::EventRecord*> & evs,
+				                     const std::vector<genie::rew::GSyst_t> & knobs,
+				                     std::vector<novarwgt::ReweightVals> & tables) const;
+
+				/// Does this knob's calculator look at the event's hadronic system
+				/// (intranuclear cascade, hadronization, resonance decay products)?
+				/// Records invented by ToGenieEvent() don't have one, so such knobs can't be computed for them.
+				static bool NeedsHadronicSystem(genie::rew::GSyst_t knob);
+
+			private:
 #if GENIE_MAJOR_VERSION >= 3
-				mutable std::unordered_map<genie::rew::GSyst_t, std::unique_ptr<genie::rew::GReWeightModel>> fCalcs;
+				using Calc_t = genie::rew::GReWeightModel;
 #else
-				mutable std::unordered_map<genie::rew::GSyst_t, std::unique_ptr<genie::rew::GReWeightI>> fCalcs;
+				using Calc_t = genie::rew::GReWeightI;
 #endif
 
+				/// GENIE calculator classes, split up further by mode where a class has several
+				enum CalcKind : unsigned int
+				{
+					kCalcCCQEMa,
+					kCalcCCQEShape,
+					kCalcCCQEZExp,
+					kCalcCCQEAxial,
+					kCalcCCQEVec,
+					kCalcCCRESMaMv,
+					kCalcCCRESShape,
+					kCalcNCRESMaMv,
+					kCalcNCRESShape,
+					kCalcCOH,
+					kCalcNonResBkg,
+					kCalcDIS,
+					kCalcDISShape,
+					kCalcDISNuclMod,
+					kCalcNCEL,
+					kCalcNC,
+					kCalcAGKY,
+					kCalcFZone,
+					kCalcINuke,
+					kCalcFGM,
+					kCalcResDecay,
+
+					kNumCalcKinds
+				};
+
+				static CalcKind KindForKnob(genie::rew::GSyst_t knob);
+
+				Calc_t * GetWeighter(CalcKind kind) const;
+
+				/// Set the given knobs (which must all belong to calculator \a kind) and reset the calculator's others,
+				/// reconfiguring only if something actually changed
+				void Configure(CalcKind kind, const std::vector<std::pair<genie::rew::GSyst_t, double>> & knobSigmas) const;
+
+				mutable std::vector<std::unique_ptr<Calc_t>> fCalcs;   ///< indexed by CalcKind
+
+				/// The value each knob is currently set to, indexed by the CalcKind of the calculator it belongs to
+				/// (so configuring a calculator only has to look through that calculator's own knobs).
+				/// Knobs that have never been touched are at nominal (0).
+				mutable std::vector<std::vector<std::pair<genie::rew::GSyst_t, double>>> fCurrentSigmas;
 		};
 
-		const ReweightObjWrapper kRWCache;
+		/// Pool of GENIE calculators for the calling thread.
+		/// Calculators are made lazily the first time a thread needs one of their knobs,
+		/// and are reused by that thread until it exits.
+		const ReweightObjWrapper & ThreadLocalRWCache();
 
 		// ---------------------------------------------
 
@@ -81,7 +155,14 @@ namespace novarwgt
 
 		/// Utility function to convert an EventRecord back into a GENIE event.
 		/// Invents some of the internals of the record as needed, so caveat emptor...
-		genie::EventRecord ToGenieEvent(const novarwgt::EventRecord &rec);
+		/// Whatever was in \a evt beforehand is overwritten.
+		void ToGenieEvent(const novarwgt::EventRecord &rec, genie::EventRecord & evt);
+
+		/// Like ToGenieEvent(rec, evt), but writes into a record belonging to the calling thread.
+		/// The record is recycled: it's overwritten by the next call from the same thread
+		/// (unless that call is for an identical event, in which case it's simply returned again),
+		/// so copy it if it needs to live longer than that.
+		const genie::EventRecord & ToGenieEvent(const novarwgt::EventRecord &rec);
 
 		// ---------------------------------------------
 
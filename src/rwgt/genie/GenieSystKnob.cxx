@@ -6,7 +6,14 @@
  *      Author: J. Wolcott <jwolcott@fnal.gov>
  */
 
+#include <algorithm>
+#include <exception>
+#include <memory>
+
 #include "NOvARwgt/rwgt/genie/GenieSystKnob.h"
+#include "NOvARwgt/rwgt/genie/StoredWgtInterpolation.h"
+#include "NOvARwgt/util/Registry.ixx"
+#include "NOvARwgt/util/WorkerPool.h"
 #include "GenieInternalTools.h"
 
 namespace novarwgt
@@ -15,12 +22,12 @@ namespace novarwgt
 	//----------------------------------------------------------------------------
 	// please note that we're explicitly specializing the constructor, but we don't need any other variants anyway
 	template<>
-	GenieSystKnob::GenieSystKnob(IRegisterable::ClassID<GenieSystKnob> &clID, novarwgt::ReweightKnob knob)
+	GenieSystKnob::GenieSystKnob(IRegisterable::ClassID<GenieSystKnob> &clID, novarwgt::ReweightKnob knob, Interpolation interp)
 	: ISystKnob(clID,
-	            novarwgt::internal::GetGenieKnobName(knob),
+	            novarwgt::internal::GetGenieKnobName(knob) + (interp == kSplineInterp ? "_spline" : ""),
 	            {StoredGenSupportCfg(GenCfg::kGENIE_AllVersions)},
 	            {0, 10}),
-	  fKnobIdx(knob), fWarnedGenieCalc(false)
+	  fKnobIdx(knob), fInterp(interp), fWarnedGenieCalc(false), fNBadStoredWgts(0), fWarnedBadStoredWgt(false)
 	{}
 
 	//----------------------------------------------------------------------------
@@ -35,36 +42,25 @@ namespace novarwgt
 			return 1.;
 
 		if (ev.genieWeights.IsSet(fKnobIdx))
-			return InterpolateStoredWgts(sigma, ev.genieWeights[fKnobIdx]);
+			return InterpolateStoredWgts(sigma, ev.genieWeights, nullptr);
 		else
 		{
 #ifdef GENIE_MAJOR_VERSION
 			double wgt;
 			// use the stored GENIE record if one exists.  that's much faster and more accurate
 			if (ev.origGenieEvt)
-				wgt = novarwgt::internal::kRWCache.GetWeight(ev.origGenieEvt,
-				                                             novarwgt::internal::ConvertToGenieKnob(fKnobIdx),
-				                                             sigma);
+				wgt = novarwgt::internal::ThreadLocalRWCache().GetWeight(ev.origGenieEvt,
+				                                                         novarwgt::internal::ConvertToGenieKnob(fKnobIdx),
+				                                                         sigma);
 			else
 			{
 				// if we have to make a new one, shenanigans may ensue.  but, no other choice.
-				if (!fWarnedGenieCalc)
-				{
-					std::cerr << "Warning: no stored weights found for knob "
-					          << "'" << novarwgt::internal::GetGenieKnobName(fKnobIdx) << "'"
-					          << " (GENIE enum value " << std::size_t(fKnobIdx) << ").  ";
-					std::cerr.flush();
-
-					std::cerr << "Invoking GENIE to calculate requested weight!" << std::endl;
-					TestIfGenIsSupported(novarwgt::kGENIE,
-					                     novarwgt::internal::GetGENIEVersion(),
-					                     novarwgt::internal::GetGENIETune());
-					std::cerr << "(No further warnings will be issued for this knob.)" << std::endl;
-				}
-				auto rec = novarwgt::internal::ToGenieEvent(ev);
-				wgt = novarwgt::internal::kRWCache.GetWeight(&rec,
-				                                             novarwgt::internal::ConvertToGenieKnob(fKnobIdx),
-				                                             sigma);
+				CheckSyntheticEvtUsable();
+				WarnGenieCalc();
+				const auto & rec = novarwgt::internal::ToGenieEvent(ev);
+				wgt = novarwgt::internal::ThreadLocalRWCache().GetWeight(&rec,
+				                                                         novarwgt::internal::ConvertToGenieKnob(fKnobIdx),
+				                                                         sigma);
 			}
 			return wgt;
 #else
@@ -77,35 +73,364 @@ namespace novarwgt
 
 	//----------------------------------------------------------------------------
 
-	double GenieSystKnob::InterpolateStoredWgts(double sigma, const novarwgt::ReweightVals &wgts) const
+	WeightAndDerivative GenieSystKnob::CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const InputVals &otherParams) const
+	{
+		if (ev.expectNoWeights)
+			return {1., 0.};
+
+		if (ev.genieWeights.IsSet(fKnobIdx))
+		{
+			WeightAndDerivative ret;
+			ret.weight = InterpolateStoredWgts(sigma, ev.genieWeights, &ret.derivative);
+			return ret;
+		}
+
+		return ISystKnob::CalcWeightAndDerivative(sigma, ev, otherParams);
+	} // GenieSystKnob::CalcWeightAndDerivative()
+
+	//----------------------------------------------------------------------------
+
+	void GenieSystKnob::CalcWeights(const double * sigmas, std::size_t n, const novarwgt::EventRecord &ev,
+	                                const InputVals &otherParams, double * wgts) const
+	{
+		if (ev.expectNoWeights || !ev.genieWeights.IsSet(fKnobIdx))
+		{
+			ISystKnob::CalcWeights(sigmas, n, ev, otherParams, wgts);
+			return;
+		}
+
+		const novarwgt::ReweightVals & vals = ev.genieWeights[fKnobIdx];
+		StoredWgtDiagnostics diag;
+		if (fInterp == kSplineInterp)
+		{
+			StoredWgtSpline builtSpline;
+			const StoredWgtSpline * cached = ev.genieWeights.Spline(fKnobIdx);
+			if (!cached)
+				builtSpline = StoredWgtSpline(vals);
+			const StoredWgtSpline & spline = cached ? *cached : builtSpline;
+
+			// (like CalcWeight(), sigma = 0 is always exactly 1)
+			if (spline.IsValid())
+			{
+				for (std::size_t idx = 0; idx < n; idx++)
+					wgts[idx] = (sigmas[idx] == 0) ? 1. : spline.Eval(sigmas[idx]);
+			}
+			else
+			{
+				std::fill(wgts, wgts + n, 1.);
+				(spline.hasNaN ? diag.nNaN : diag.nInf) += std::size_t(n - std::count(sigmas, sigmas + n, 0.));
+			}
+		}
+		else
+		{
+			// bad entries only matter at the sigmas that use them, so this one has to go sigma by sigma
+			for (std::size_t idx = 0; idx < n; idx++)
+				wgts[idx] = (sigmas[idx] == 0) ? 1. : InterpolateStoredWgt(StoredWgtCoeffs::ForSigma(sigmas[idx]), vals, diag);
+		}
+
+		NoteBadStoredWgts(diag);
+	} // GenieSystKnob::CalcWeights()
+
+	//----------------------------------------------------------------------------
+
+	void GenieSystKnob::CalcWeightTables(const std::vector<const novarwgt::EventRecord*> & evts,
+	                                     std::vector<novarwgt::ReweightVals> & tables) const
+	{
+		tables.resize(evts.size());
+
+#ifdef GENIE_MAJOR_VERSION
+		// GENIE records for the events that need them, and where their results go
+		std::vector<const genie::EventRecord*> genieEvts;
+		std::vector<std::size_t> genieEvtIdxs;
+		std::vector<std::unique_ptr<genie::EventRecord>> madeEvts;
+#endif
+
+		for (std::size_t evtIdx = 0; evtIdx < evts.size(); evtIdx++)
+		{
+			const novarwgt::EventRecord & ev = *evts[evtIdx];
+			if (ev.expectNoWeights)
+				tables[evtIdx] = {1, 1, 1, 1};
+			else if (ev.genieWeights.IsSet(fKnobIdx))
+				tables[evtIdx] = ev.genieWeights[fKnobIdx];
+			else
+			{
+#ifdef GENIE_MAJOR_VERSION
+				if (ev.origGenieEvt)
+					genieEvts.push_back(ev.origGenieEvt);
+				else
+				{
+					CheckSyntheticEvtUsable();
+					WarnGenieCalc();
+					madeEvts.push_back(std::make_unique<genie::EventRecord>());
+					novarwgt::internal::ToGenieEvent(ev, *madeEvts.back());
+					genieEvts.push_back(madeEvts.back().get());
+				}
+				genieEvtIdxs.push_back(evtIdx);
+#else
+				throw std::runtime_error("NOvARwgt::GenieSystKnob: GENIE weight for knob '" + std::to_string(fKnobIdx) + "'"
+				                         + "requested but stored weights not available and GENIE support was not built into NOvARwgt");
+#endif
+			}
+		}
+
+#ifdef GENIE_MAJOR_VERSION
+		if (genieEvts.empty())
+			return;
+
+		// sigma-major: the outer loop is over sigmas, so GENIE only reconfigures once per sigma
+		std::vector<double> wgts;
+		novarwgt::internal::ThreadLocalRWCache().GetWeights(genieEvts,
+		                                                    novarwgt::internal::ConvertToGenieKnob(fKnobIdx),
+		                                                    {-2, -1, +1, +2},
+		                                                    wgts);
+		const std::size_t nGenie = genieEvts.size();
+		for (std::size_t idx = 0; idx < nGenie; idx++)
+		{
+			auto & table = tables[genieEvtIdxs[idx]];
+			table.minus2sigma = wgts[idx];
+			table.minus1sigma = wgts[nGenie + idx];
+			table.plus1sigma  = wgts[2*nGenie + idx];
+			table.plus2sigma  = wgts[3*nGenie + idx];
+		}
+#endif
+	} // GenieSystKnob::CalcWeightTables()
+
+	//----------------------------------------------------------------------------
+
+	void GenieSystKnob::WarnGenieCalc() const
+	{
+#ifdef GENIE_MAJOR_VERSION
+		if (fWarnedGenieCalc.exchange(true))
+			return;
+
+		std::cerr << "Warning: no stored weights found for knob "
+		          << "'" << novarwgt::internal::GetGenieKnobName(fKnobIdx) << "'"
+		          << " (GENIE enum value " << std::size_t(fKnobIdx) << ").  ";
+		std::cerr.flush();
+
+		std::cerr << "Invoking GENIE to calculate requested weight!" << std::endl;
+		TestIfGenIsSupported(novarwgt::kGENIE,
+		                     novarwgt::internal::GetGENIEVersion(),
+		                     novarwgt::internal::GetGENIETune());
+		std::cerr << "(No further warnings will be issued for this knob.)" << std::endl;
+#endif
+	}
+
+	//----------------------------------------------------------------------------
+
+	void GenieSystKnob::CheckSyntheticEvtUsable() const
+	{
+#ifdef GENIE_MAJOR_VERSION
+		const auto genieKnob = novarwgt::internal::ConvertToGenieKnob(fKnobIdx);
+		if (novarwgt::internal::ReweightObjWrapper::NeedsHadronicSystem(genieKnob))
+			throw std::runtime_error("NOvARwgt::GenieSystKnob: GENIE knob '" + novarwgt::internal::GetGenieKnobName(fKnobIdx) + "'"
+			                         + " depends on the event's hadronic system, which a record not made from a GENIE event doesn't have."
+			                         + "  Supply stored weights, or convert the original GENIE event (so origGenieEvt is set).");
+#endif
+	}
+
+	//----------------------------------------------------------------------------
+
+	void GenieSystKnob::FillWeightTables(std::vector<novarwgt::EventRecord> & evts,
+	                                     const std::vector<novarwgt::ReweightKnob> & knobs,
+	                                     novarwgt::WorkerPool * pool, Interpolation interp)
 	{
-		double weight = 1;
-		if (sigma == 0)
-			return weight;
-
-		// Linear interpolation
-		double w0, w1, y0, y1;
-		if(sigma >= 1              )      {w0 = sigma-1; w1 =  2-sigma; y0 = wgts.plus2sigma;  y1 = wgts.plus1sigma; }
-		else if(sigma >= 0  && sigma < 1) {w0 = sigma-0; w1 =  1-sigma; y0 = wgts.plus1sigma;  y1 = 1;               }
-		else if(sigma >= -1 && sigma < 0) {w0 = sigma+1; w1 =  0-sigma; y0 = 1;                y1 = wgts.minus1sigma;}
-		else                /*sigma < -1*/{w0 = sigma+2; w1 = -1-sigma; y0 = wgts.minus1sigma; y1 = wgts.minus2sigma;}
-
-
-		// These tests for NaN don't actually work. We'd have to disable the
-		// FE_INVALID exceptions we currently have turned on.
-		if(std::isnan(y0) || std::isnan(y1)){
-			std::cerr << "Warning: NaN GENIE weight found for '" << this->GetName() << "', ignoring." << std::endl;
-			return 1.0;
+		if (evts.empty() || knobs.empty())
+			return;
+
+		// look these up before starting any threads, since the registry isn't thread-safe
+		std::vector<const GenieSystKnob*> knobObjs;
+		for (const auto & knob : knobs)
+			knobObjs.push_back(GetGenieSystKnob(knob));
+
+		// likewise, the warning checks the running GENIE's version and tune,
+		// which reads GENIE's global state.  so do it here, on the calling thread, before the workers start
+		// (records invented from scratch also have to be usable with every knob that needs them)
+		std::vector<bool> synthesized(knobs.size(), false);
+		for (const auto & ev : evts)
+		{
+			if (ev.origGenieEvt || ev.expectNoWeights)
+				continue;
+			for (std::size_t knobIdx = 0; knobIdx < knobs.size(); knobIdx++)
+				synthesized[knobIdx] = synthesized[knobIdx] || !ev.genieWeights.IsSet(knobs[knobIdx]);
 		}
+		for (std::size_t knobIdx = 0; knobIdx < knobs.size(); knobIdx++)
+		{
+			if (!synthesized[knobIdx])
+				continue;
+			knobObjs[knobIdx]->CheckSyntheticEvtUsable();
+			knobObjs[knobIdx]->WarnGenieCalc();
+		}
+
+#ifdef GENIE_MAJOR_VERSION
+		std::vector<genie::rew::GSyst_t> genieKnobs;
+		for (const auto & knob : knobs)
+			genieKnobs.push_back(novarwgt::internal::ConvertToGenieKnob(knob));
+
+		auto needsTable = [&knobs](const novarwgt::EventRecord & ev)
+		{
+			return !ev.expectNoWeights
+			       && !std::all_of(knobs.begin(), knobs.end(), [&ev](novarwgt::ReweightKnob knob) { return ev.genieWeights.IsSet(knob); });
+		};
+#endif
+
+		// each thread gets a contiguous block of events, so no event is touched by two threads
+		auto fillBlock = [&](std::size_t begin, std::size_t end)
+		{
+			// the splines have to be (re)built once the tables are all there
+			auto buildSplines = [&]()
+			{
+				if (interp != kSplineInterp)
+					return;
+				for (std::size_t evtIdx = begin; evtIdx < end; evtIdx++)
+					evts[evtIdx].genieWeights.BuildSplines(knobs);
+			};
+
+#ifdef GENIE_MAJOR_VERSION
+			// every event that's missing any of the tables gets one GENIE record,
+			// which is shared by all the knobs.  then the calculators sweep through them knob by knob
+			std::vector<std::size_t> evtIdxs;
+			std::vector<const genie::EventRecord*> genieEvts;
+			std::vector<std::unique_ptr<genie::EventRecord>> madeEvts;
+			for (std::size_t evtIdx = begin; evtIdx < end; evtIdx++)
+			{
+				const novarwgt::EventRecord & ev = evts[evtIdx];
+				if (!needsTable(ev))
+					continue;
+
+				evtIdxs.push_back(evtIdx);
+				if (ev.origGenieEvt)
+					genieEvts.push_back(ev.origGenieEvt);
+				else
+				{
+					madeEvts.push_back(std::make_unique<genie::EventRecord>());
+					novarwgt::internal::ToGenieEvent(ev, *madeEvts.back());
+					genieEvts.push_back(madeEvts.back().get());
+				}
+			}
+			if (evtIdxs.empty())
+			{
+				buildSplines();
+				return;
+			}
+
+			std::vector<novarwgt::ReweightVals> tables;
+			novarwgt::internal::ThreadLocalRWCache().GetWeightTables(genieEvts, genieKnobs, tables);
+			for (std::size_t knobIdx = 0; knobIdx < knobs.size(); knobIdx++)
+			{
+				for (std::size_t idx = 0; idx < evtIdxs.size(); idx++)
+				{
+					auto & rwList = evts[evtIdxs[idx]].genieWeights;
+					if (!rwList.IsSet(knobs[knobIdx]))
+						rwList[knobs[knobIdx]] = tables[knobIdx * evtIdxs.size() + idx];
+				}
+			}
+			buildSplines();
+#else
+			// without GENIE, all we can do is complain about anything that's missing
+			std::vector<const novarwgt::EventRecord*> blockEvts;
+			for (std::size_t evtIdx = begin; evtIdx < end; evtIdx++)
+				blockEvts.push_back(&evts[evtIdx]);
+			std::vector<novarwgt::ReweightVals> tables;
+			for (const auto & knobObj : knobObjs)
+				knobObj->CalcWeightTables(blockEvts, tables);
+			buildSplines();
+#endif
+		};
 
-		if(std::isinf(y0) || std::isinf(y1)){
-			std::cerr << "Warning: Inf GENIE weight found for '" << this->GetName() << "', ignoring." << std::endl;
-			return 1.0;
+		if (!pool)
+		{
+			fillBlock(0, evts.size());
+			return;
 		}
 
-		weight *= (w0*y0 + w1*y1);
+		// one block per worker, so GENIE reconfigures as few times as possible
+		const std::size_t nBlocks = std::min(std::size_t(pool->NThreads()), evts.size());
+		const std::size_t blockSize = (evts.size() + nBlocks - 1) / nBlocks;
+		pool->Run(nBlocks, [&fillBlock, &evts, blockSize](std::size_t blockIdx)
+		{
+			const std::size_t begin = std::min(blockIdx * blockSize, evts.size());
+			fillBlock(begin, std::min(begin + blockSize, evts.size()));
+		});
+	} // GenieSystKnob::FillWeightTables()
+
+	//----------------------------------------------------------------------------
+
+	void FillGenieWeightTables(std::vector<novarwgt::EventRecord> & evts,
+	                           const std::vector<novarwgt::ReweightKnob> & knobs,
+	                           unsigned int nThreads,
+	                           GenieSystKnob::Interpolation interp)
+	{
+		// a single thread may as well be the calling one
+		GenieSystKnob::FillWeightTables(evts, knobs, nThreads == 1 ? nullptr : &novarwgt::WorkerPool::Shared(nThreads), interp);
+	}
+
+	//----------------------------------------------------------------------------
+
+	void FillGenieWeightTables(std::vector<novarwgt::EventRecord> & evts,
+	                           const std::vector<novarwgt::ReweightKnob> & knobs,
+	                           novarwgt::WorkerPool & pool,
+	                           GenieSystKnob::Interpolation interp)
+	{
+		GenieSystKnob::FillWeightTables(evts, knobs, &pool, interp);
+	}
+
+	//----------------------------------------------------------------------------
+
+	void BuildGenieWeightSplines(std::vector<novarwgt::EventRecord> & evts,
+	                             const std::vector<novarwgt::ReweightKnob> & knobs)
+	{
+		for (auto & ev : evts)
+			ev.genieWeights.BuildSplines(knobs);
+	}
+
+	//----------------------------------------------------------------------------
+
+	double GenieSystKnob::InterpolateStoredWgts(double sigma, const novarwgt::ReweightList &rwList, double * deriv) const
+	{
+		const novarwgt::ReweightVals & wgts = rwList[fKnobIdx];
+		StoredWgtDiagnostics diag;
+		double weight;
+		if (fInterp == kSplineInterp)
+		{
+			// use the spline cached in the record when there is one (see BuildGenieWeightSplines());
+			// otherwise it has to be built here
+			StoredWgtSpline builtSpline;
+			const StoredWgtSpline * cached = rwList.Spline(fKnobIdx);
+			if (!cached)
+				builtSpline = StoredWgtSpline(wgts);
+			const StoredWgtSpline & spline = cached ? *cached : builtSpline;
+			diag.nNaN = spline.hasNaN;
+			diag.nInf = !spline.hasNaN && spline.hasInf;
+			weight = spline.Eval(sigma);
+			if (deriv)
+				*deriv = spline.Derivative(sigma);
+		}
+		else
+		{
+			weight = InterpolateStoredWgt(StoredWgtCoeffs::ForSigma(sigma), wgts, diag);
+			if (deriv)
+				*deriv = (diag.nNaN > 0 || diag.nInf > 0) ? 0. : StoredWgtCoeffs::DerivativeForSigma(sigma).Apply(wgts);
+		}
+
+		NoteBadStoredWgts(diag);
 
 		return weight;
 	}
 
+	//----------------------------------------------------------------------------
+
+	void GenieSystKnob::NoteBadStoredWgts(const StoredWgtDiagnostics & diag) const
+	{
+		// don't flood the output (or slow down the hot path) if a whole sample has bad tables:
+		// just count them, and only say something the first time
+		if (diag.nNaN == 0 && diag.nInf == 0)
+			return;
+
+		fNBadStoredWgts += diag.nNaN + diag.nInf;
+		if (!fWarnedBadStoredWgt.exchange(true))
+			std::cerr << "Warning: " << (diag.nNaN > 0 ? "NaN" : "Inf") << " GENIE weight found for '" << this->GetName() << "', ignoring."
+			          << "  (Further bad weights for this knob will only be counted; see GenieSystKnob::NBadStoredWgts().)" << std::endl;
+	}
+
 }
@@ -40,8 +40,8 @@ namespace novarwgt
 		if (!ev.isCC)
 			return 1.;
 
-		double qmag = ev.q.Vect().Mag();
-		double q0 = ev.q.E();
+		double qmag = ev.q3();
+		double q0 = ev.q0();
 		bool isAntiNu = ev.nupdg < 0;
 		int struckNuclPair = ev.struckNucl;   // from GENIE: 2000000200 --> nn, 2000000201 --> np, 2000000201 --> pp
 
@@ -66,23 +66,47 @@ namespace novarwgt
 
 	//---------------------------------------------------------------------------
 
+	std::vector<const novarwgt::IWeightGenerator*> MECq0ShapeSyst2017::Dependencies() const
+	{
+		auto deps = ISystKnob::Dependencies();
+		deps.push_back(fQELikeWgtr);
+		deps.push_back(fRESLikeWgtr);
+		return deps;
+	}
+
+	//---------------------------------------------------------------------------
+
 	const TF1 MECEnuShapeSyst2017::sRwFn("f_MECEnuRwFn2018", "1/(2.5*x+1)");
 
-	double MECEnuShapeSyst2017::CalcWeight(double sigma,
-	                                       const novarwgt::EventRecord &ev,
-	                                       const InputVals &) const
+	double MECEnuShapeSyst2017::Slope(const novarwgt::EventRecord &ev) const
 	{
-		double wgt = 1;
-		if (ev.reaction != novarwgt::kScMEC) return wgt;
+		if (ev.reaction != novarwgt::kScMEC) return 0;
 		if (    (fHelicity == kNeutrino     && ev.nupdg < 0)
 		     || (fHelicity == kAntineutrino && ev.nupdg > 0) )
-			return wgt;
+			return 0;
+
+		if (ev.Enu < 0) return 0;
 
-		if (ev.Enu < 0) return wgt;
+		return MECEnuShapeSyst2017::sRwFn.Eval(ev.Enu);
+	}
 
-		wgt = 1 + sigma * MECEnuShapeSyst2017::sRwFn.Eval(ev.Enu);
+	//---------------------------------------------------------------------------
 
-		return wgt;
+	double MECEnuShapeSyst2017::CalcWeight(double sigma,
+	                                       const novarwgt::EventRecord &ev,
+	                                       const InputVals &) const
+	{
+		return 1 + sigma * Slope(ev);
+	}
+
+	//---------------------------------------------------------------------------
+
+	WeightAndDerivative MECEnuShapeSyst2017::CalcWeightAndDerivative(double sigma,
+	                                                                 const novarwgt::EventRecord &ev,
+	                                                                 const InputVals &) const
+	{
+		const double slope = Slope(ev);
+		return {1 + sigma * slope, slope};
 	}
 
 	//---------------------------------------------------------------------------
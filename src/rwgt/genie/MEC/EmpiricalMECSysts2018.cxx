@@ -43,4 +43,14 @@ namespace novarwgt
 		return wgt;
 	}
 
+	//---------------------------------------------------------------------------
+
+	std::vector<const novarwgt::IWeightGenerator*> MECQ0Q3RespSyst2018::Dependencies() const
+	{
+		auto deps = ISystKnob::Dependencies();
+		deps.push_back(fQELikeWgtr);
+		deps.push_back(fRESLikeWgtr);
+		return deps;
+	}
+
 }
\ No newline at end of file
@@ -21,8 +21,8 @@ namespace novarwgt
 		if (ev.reaction != novarwgt::kScMEC /*|| !params.at("EmpiricalMEC")*/)
 			return 1.;
 
-		double qmag = ev.q.Vect().Mag();
-		double q0 = ev.q.E();
+		double qmag = ev.q3();
+		double q0 = ev.q0();
 		return this->fHist.GetValueInRange(qmag, q0,
 		                                   {1,-1}, {1,-1},  // these two are defaults -- use the whole bin range
 		                                   {0, std::numeric_limits<double>::infinity()}  // don't let weights go below zero.
@@ -70,6 +70,16 @@ namespace novarwgt
 
 	//----------------------------------------------------------------------
 
+	std::vector<const novarwgt::IWeightGenerator*> MAQEGenieReducedSyst2018::Dependencies() const
+	{
+		auto deps = ISystKnob::Dependencies();
+		for (const auto & wgtr : fGENIEMAQEKnob->Dependencies())
+			deps.push_back(wgtr);
+		return deps;
+	}
+
+	//----------------------------------------------------------------------
+
 	double MAQEGenieReducedSyst2017::CalcWeight(double sigma, const novarwgt::EventRecord &ev,
 	                                            const InputVals &otherParams) const
 	{
@@ -81,4 +91,14 @@ namespace novarwgt
 
 		return fGENIEMAQEKnob->GetWeight(rescaleFactor * sigma, ev, otherParams);
 	}
+
+	//----------------------------------------------------------------------
+
+	std::vector<const novarwgt::IWeightGenerator*> MAQEGenieReducedSyst2017::Dependencies() const
+	{
+		auto deps = ISystKnob::Dependencies();
+		for (const auto & wgtr : fGENIEMAQEKnob->Dependencies())
+			deps.push_back(wgtr);
+		return deps;
+	}
 }
\ No newline at end of file
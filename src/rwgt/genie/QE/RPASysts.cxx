@@ -48,6 +48,15 @@ namespace novarwgt
 
 	//----------------------------------------------------------------------
 
+	std::vector<const novarwgt::IWeightGenerator*> RPACCQESystSA::Dependencies() const
+	{
+		auto deps = ISystKnob::Dependencies();
+		deps.push_back(GetWeighter<novarwgt::RPAWeightCCQESA>());
+		return deps;
+	}
+
+	//----------------------------------------------------------------------
+
 	double RPACCQEshapeSyst::CalcWeight(double sigma, const novarwgt::EventRecord &ev, const InputVals &otherParams) const
 	{
 		double wgt = 1;
@@ -65,34 +74,80 @@ namespace novarwgt
 
 	//----------------------------------------------------------------------
 
-	double RPARESSyst::CalcWeight(double sigma, const novarwgt::EventRecord &ev, const InputVals &otherParams) const
+	std::vector<const novarwgt::IWeightGenerator*> RPACCQEshapeSyst::Dependencies() const
 	{
-		double wgt = 1.0;
+		auto deps = ISystKnob::Dependencies();
+		deps.push_back(fWgtrUp);
+		deps.push_back(fWgtrDown);
+		return deps;
+	}
 
-		// todo: should this really be applied to NC?
-		if (ev.reaction != novarwgt::kScResonant)
-			return wgt;
+	//----------------------------------------------------------------------
 
+	double RPARESSyst::EffectiveSigma(double sigma) const
+	{
 		// like RPACCQESystSA, this systematic is one-sided
 		// (negative variations are not allowed
 		// because they don't mean anything.)
 		// +1 sigma turns off the RPA effect completely
 		if ( sigma < 0 )
-			return wgt;
+			return 0;
 
 		// add in a bit of increase for 2sigma to give CAFAna one more point to sample
 		// (helps extrapolation not go crazy).
 		// only needed when clamping at 1sigma (which we do when we're 'undoing' the RPA effect,
 		// because >1 sigma 'undoes' more than the CV weight)
 		if (sigma > 2 && !fSystIsEnableEffect && fDoExtrapKludge)
-			sigma = 1.1;
+			return 1.1;
 		else if(sigma > 1)
-			sigma = 1;
+			return 1;
+
+		return sigma;
+	}
+
+	//----------------------------------------------------------------------
+
+	double RPARESSyst::Slope(const novarwgt::EventRecord &ev, const InputVals &otherParams) const
+	{
+		// todo: should this really be applied to NC?
+		if (ev.reaction != novarwgt::kScResonant)
+			return 0;
 
 		double baseWgt = fWgtr->GetWeight(ev, otherParams);
 		if (!fSystIsEnableEffect)
 			baseWgt = 1./baseWgt;
-		wgt *= 1 + sigma * (baseWgt - 1);
-		return wgt;
+		return baseWgt - 1;
+	}
+
+	//----------------------------------------------------------------------
+
+	double RPARESSyst::CalcWeight(double sigma, const novarwgt::EventRecord &ev, const InputVals &otherParams) const
+	{
+		const double effSigma = EffectiveSigma(sigma);
+		if (effSigma == 0)
+			return 1.0;
+
+		return 1 + effSigma * Slope(ev, otherParams);
+	}
+
+	//----------------------------------------------------------------------
+
+	WeightAndDerivative RPARESSyst::CalcWeightAndDerivative(double sigma, const novarwgt::EventRecord &ev, const InputVals &otherParams) const
+	{
+		if (sigma < 0)
+			return {1.0, 0};
+
+		// linear in sigma between 0 and 1 (using the slope above 0 at 0 itself), and flat outside that
+		const double slope = Slope(ev, otherParams);
+		return {1 + EffectiveSigma(sigma) * slope, (sigma <= 1) ? slope : 0};
+	}
+
+	//----------------------------------------------------------------------
+
+	std::vector<const novarwgt::IWeightGenerator*> RPARESSyst::Dependencies() const
+	{
+		auto deps = ISystKnob::Dependencies();
+		deps.push_back(fWgtr);
+		return deps;
 	}
 }
\ No newline at end of file
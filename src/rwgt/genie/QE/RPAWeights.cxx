@@ -61,16 +61,16 @@ namespace novarwgt
 	{
 		// original code from R. Gran excludes tau neutrinos, though I'm not sure why it matters.
 		// Won't hurt anything anyway.
-		if (abs(ev.nupdg) != 12 && abs(ev.nupdg) != 14)
+		const std::uint32_t cls = ev.Classification();
+		if (!(cls & (kEvtNuE | kEvtNuMu)))
 			return false;
 
 		// don't correct Hydrogen, unless explicitly trying to reproduce old buggy behavior
-		if (!fApplyToHydrogen && ev.A == 1)
+		if (!fApplyToHydrogen && (cls & kEvtFreeNucleon))
 			return false;
 
 		// if specified, apply only to reactions requested
-		if (this->fCurrent != novarwgt::kRxnUnspecified &&
-		    ((ev.isCC && this->fCurrent == novarwgt::kRxnNC) || (!ev.isCC && this->fCurrent == novarwgt::kRxnCC)))
+		if ((this->fCurrent == novarwgt::kRxnCC && !(cls & kEvtCC)) || (this->fCurrent == novarwgt::kRxnNC && !(cls & kEvtNC)))
 			return false;
 		if (this->fReaction != novarwgt::kScNull && ev.reaction != this->fReaction)
 			return false;
@@ -85,14 +85,18 @@ namespace novarwgt
 		if (!this->OkReaction(ev, vals))
 			return 1.;
 
-		double qmag = ev.q.Vect().Mag();
-		double q0 = ev.q.E();
+		double qmag = ev.q3();
+		double q0 = ev.q0();
 		bool isAntiNu = fForceNu ? false : ev.nupdg < 0;
 
 		auto &hist = (isAntiNu) ? this->fHist_nubar : this->fHist_nu;
-		auto &minBin = (isAntiNu) ? this->fq0MinBin_nubar : this->fq0MinBin_nu;
+		auto &minBinCache = (isAntiNu) ? this->fq0MinBin_nubar : this->fq0MinBin_nu;
+		int minBin = minBinCache.load(std::memory_order_relaxed);
 		if (minBin < 0)
+		{
 			minBin = hist->FindFirstBinAbove(0, 2);
+			minBinCache.store(minBin, std::memory_order_relaxed);
+		}
 		double val = hist.GetValueInRange(qmag, q0,
 		                                  {1, hist->GetNbinsX()},
 		                                  {minBin, hist->GetNbinsY()},
@@ -111,7 +115,7 @@ namespace novarwgt
 		if (!this->OkReaction(ev, vals))
 			return 1.;
 
-		double q2 = -ev.q.Mag2();
+		double q2 = ev.Q2();
 		bool isAntiNu = ev.nupdg < 0;
 
 		auto &hist = (isAntiNu) ? this->fHist_nubar : this->fHist_nu;
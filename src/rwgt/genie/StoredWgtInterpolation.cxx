@@ -0,0 +1,288 @@
+/*
+ * StoredWgtInterpolation.cxx:
+ *  Interpolation of stored GENIE weight tables (-2, -1, +1, +2 sigma) to arbitrary sigma.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "NOvARwgt/rwgt/genie/StoredWgtInterpolation.h"
+
+namespace novarwgt
+{
+	namespace
+	{
+		inline std::int32_t FloatBits(float x)
+		{
+			std::int32_t bits;
+			std::memcpy(&bits, &x, sizeof(bits));
+			return bits;
+		}
+
+		inline float BitsFloat(std::int32_t bits)
+		{
+			float x;
+			std::memcpy(&x, &bits, sizeof(x));
+			return x;
+		}
+
+		/// For every event, wgts[knob] = one[knob] + sum over the knob's NCols table entries of coeff * entry,
+		/// where entries whose \a keep mask is 0 are dropped, and a weight using any NaN or infinite entry is replaced by 1.
+		///
+		/// Everything in the knob loop is arithmetic on bit masks (no comparisons of floating-point values,
+		/// which with the default -ftrapping-math keep GCC from if-converting, and no ?: on them),
+		/// so it vectorizes; check with -fopt-info-vec.
+		template <std::size_t NCols>
+		void ApplyMaskedCoeffs(const float * __restrict table,
+		                       std::size_t nEvts,
+		                       std::size_t nKnobs,
+		                       const double * __restrict one,
+		                       const double * __restrict coeffs,
+		                       const std::int32_t * __restrict keep,
+		                       double * __restrict wgts,
+		                       StoredWgtDiagnostics * diag)
+		{
+			const std::int32_t kExpBits = 0x7f800000;   // a float is NaN if its magnitude bits are above this, infinite if equal
+
+			std::size_t nNaN = 0;
+			std::size_t nInf = 0;
+			for (std::size_t evtIdx = 0; evtIdx < nEvts; evtIdx++)
+			{
+				const float * row = table + evtIdx * nKnobs * NCols;
+				double * out = wgts + evtIdx * nKnobs;
+				std::int32_t rowNaN = 0;
+				std::int32_t rowInf = 0;
+				for (std::size_t knobIdx = 0; knobIdx < nKnobs; knobIdx++)
+				{
+					double wgt = one[knobIdx];
+					std::int32_t anyNaN = 0;
+					std::int32_t anyInf = 0;
+#if defined(__clang__)
+					#pragma unroll
+#elif defined(__GNUC__)
+					#pragma GCC unroll 16
+#endif
+					for (std::size_t col = 0; col < NCols; col++)
+					{
+						const std::int32_t bits = FloatBits(row[NCols * knobIdx + col]) & keep[NCols * knobIdx + col];
+						const std::int32_t magnitude = bits & 0x7fffffff;
+						const std::int32_t isNaN = magnitude > kExpBits;
+						const std::int32_t isInf = magnitude == kExpBits;
+						anyNaN |= isNaN;
+						anyInf |= isInf;
+						wgt += coeffs[NCols * knobIdx + col] * double(BitsFloat(bits & ((isNaN | isInf) - 1)));  // bad entries zeroed, so wgt stays finite
+					}
+					rowNaN += anyNaN;
+					rowInf += anyInf & ~anyNaN;
+					const double bad = double(anyNaN | anyInf);
+					out[knobIdx] = wgt * (1 - bad) + bad;
+				}
+				nNaN += std::size_t(rowNaN);
+				nInf += std::size_t(rowInf);
+			}
+
+			if (diag)
+			{
+				diag->nNaN += nNaN;
+				diag->nInf += nInf;
+			}
+		}
+	}
+
+	//----------------------------------------------------------------------------
+	StoredWgtCoeffs StoredWgtCoeffs::ForSigma(double sigma)
+	{
+		StoredWgtCoeffs coeffs;
+		if (sigma == 0)
+			return coeffs;
+
+		// weight = w0*y0 + w1*y1 for the two nodes y0, y1 bracketing sigma
+		coeffs.one = 0;
+		if (sigma >= 1)                     { coeffs.p2 = sigma - 1;  coeffs.p1 = 2 - sigma;  }
+		else if (sigma >= 0 && sigma < 1)   { coeffs.p1 = sigma;      coeffs.one = 1 - sigma; }
+		else if (sigma >= -1 && sigma < 0)  { coeffs.one = sigma + 1; coeffs.m1 = -sigma;     }
+		else            /* sigma < -1 */    { coeffs.m1 = sigma + 2;  coeffs.m2 = -1 - sigma; }
+
+		return coeffs;
+	}
+
+	//----------------------------------------------------------------------------
+	StoredWgtCoeffs StoredWgtCoeffs::DerivativeForSigma(double sigma)
+	{
+		// slopes of the segments in ForSigma()
+		StoredWgtCoeffs coeffs;
+		coeffs.one = 0;
+		if (sigma >= 1)                     { coeffs.p2 = 1;  coeffs.p1 = -1;   }
+		else if (sigma >= 0 && sigma < 1)   { coeffs.p1 = 1;  coeffs.one = -1;  }
+		else if (sigma >= -1 && sigma < 0)  { coeffs.one = 1; coeffs.m1 = -1;   }
+		else            /* sigma < -1 */    { coeffs.m1 = 1;  coeffs.m2 = -1;   }
+
+		return coeffs;
+	}
+
+	//----------------------------------------------------------------------------
+	void InterpolateStoredWgts(const float * tables,
+	                           std::size_t nEvts,
+	                           std::size_t nKnobs,
+	                           const double * sigmas,
+	                           double * wgts,
+	                           StoredWgtDiagnostics * diag)
+	{
+		// structure-of-arrays coefficients, laid out like one event's row of the table
+		std::vector<double> one(nKnobs), coeffs(4 * nKnobs);
+		std::vector<std::int32_t> keep(4 * nKnobs);
+		for (std::size_t knobIdx = 0; knobIdx < nKnobs; knobIdx++)
+		{
+			const auto knobCoeffs = StoredWgtCoeffs::ForSigma(sigmas[knobIdx]);
+			one[knobIdx] = knobCoeffs.one;
+			const double entryCoeffs[4] = {knobCoeffs.m2, knobCoeffs.m1, knobCoeffs.p1, knobCoeffs.p2};
+			for (unsigned int entry = 0; entry < 4; entry++)
+			{
+				coeffs[4 * knobIdx + entry] = entryCoeffs[entry];
+				keep[4 * knobIdx + entry] = entryCoeffs[entry] != 0 ? -1 : 0;
+			}
+		}
+
+		ApplyMaskedCoeffs<4>(tables, nEvts, nKnobs, one.data(), coeffs.data(), keep.data(), wgts, diag);
+	}
+
+	//----------------------------------------------------------------------------
+	void InterpolateStoredWgts(const novarwgt::ReweightVals * tables,
+	                           std::size_t nEvts,
+	                           std::size_t nKnobs,
+	                           const double * sigmas,
+	                           double * wgts,
+	                           StoredWgtDiagnostics * diag)
+	{
+		static_assert(sizeof(novarwgt::ReweightVals) == 4 * sizeof(float), "ReweightVals must be exactly 4 packed floats");
+		InterpolateStoredWgts(reinterpret_cast<const float*>(tables), nEvts, nKnobs, sigmas, wgts, diag);
+	}
+
+	//----------------------------------------------------------------------------
+	StoredWgtSpline::StoredWgtSpline(const novarwgt::ReweightVals & vals)
+	{
+		std::memcpy(source, &vals, sizeof(source));
+
+		const double y[5] = {vals.minus2sigma, vals.minus1sigma, 1, vals.plus1sigma, vals.plus2sigma};
+		for (const auto val : y)
+		{
+			hasNaN |= std::isnan(val);
+			hasInf |= std::isinf(val);
+		}
+		if (!IsValid())
+			return;
+
+		// nodes are 1 sigma apart, so secant slopes are just differences
+		double delta[4];
+		for (unsigned int seg = 0; seg < 4; seg++)
+			delta[seg] = y[seg+1] - y[seg];
+
+		// node slopes: one-sided at the ends, averaged in the interior (zero at local extrema)
+		double m[5];
+		m[0] = delta[0];
+		m[4] = delta[3];
+		for (unsigned int node = 1; node < 4; node++)
+			m[node] = (delta[node-1] * delta[node] <= 0) ? 0 : (delta[node-1] + delta[node]) / 2;
+
+		// Fritsch-Carlson limiter, which keeps each segment monotone
+		for (unsigned int seg = 0; seg < 4; seg++)
+		{
+			if (delta[seg] == 0)
+			{
+				m[seg] = m[seg+1] = 0;
+				continue;
+			}
+			const double a = m[seg] / delta[seg];
+			const double b = m[seg+1] / delta[seg];
+			const double r2 = a*a + b*b;
+			if (r2 > 9)
+			{
+				const double tau = 3 / std::sqrt(r2);
+				m[seg] = tau * a * delta[seg];
+				m[seg+1] = tau * b * delta[seg];
+			}
+		}
+
+		// cubic Hermite polynomial on each segment, in powers of the offset into the segment
+		for (unsigned int seg = 0; seg < 4; seg++)
+		{
+			coeffs[seg][0] = y[seg];
+			coeffs[seg][1] = m[seg];
+			coeffs[seg][2] = 3*delta[seg] - 2*m[seg] - m[seg+1];
+			coeffs[seg][3] = m[seg] + m[seg+1] - 2*delta[seg];
+		}
+	}
+
+	//----------------------------------------------------------------------------
+	bool StoredWgtSpline::BuiltFrom(const novarwgt::ReweightVals & vals) const
+	{
+		static_assert(sizeof(novarwgt::ReweightVals) == sizeof(source), "ReweightVals must be exactly 4 packed floats");
+		return std::memcmp(source, &vals, sizeof(source)) == 0;
+	}
+
+	//----------------------------------------------------------------------------
+	void BuildStoredWgtSplines(const novarwgt::ReweightVals * tables, std::size_t n, float * coeffs)
+	{
+		for (std::size_t idx = 0; idx < n; idx++)
+		{
+			const StoredWgtSpline spline(tables[idx]);
+			float * out = coeffs + idx * kStoredWgtSplineSize;
+			for (unsigned int seg = 0; seg < 4; seg++)
+			{
+				for (unsigned int power = 0; power < 4; power++)
+					out[4 * seg + power] = spline.coeffs[seg][power];
+
+				// a marker whichever segment ends up being used will trip over
+				if (!spline.IsValid())
+					out[4 * seg] = spline.hasNaN ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+			}
+		}
+	}
+
+	//----------------------------------------------------------------------------
+	void InterpolateStoredWgtSplines(const float * splineCoeffs,
+	                                 std::size_t nEvts,
+	                                 std::size_t nKnobs,
+	                                 const double * sigmas,
+	                                 double * wgts,
+	                                 StoredWgtDiagnostics * diag)
+	{
+		// where each knob's sigma falls is the same for every event,
+		// so the spline becomes a fixed linear combination of its coefficients:
+		// the powers of t in the segment containing sigma, and nothing from the others
+		std::vector<double> zero(nKnobs, 0.), basis(kStoredWgtSplineSize * nKnobs, 0.);
+		std::vector<std::int32_t> keep(kStoredWgtSplineSize * nKnobs, 0);
+		for (std::size_t knobIdx = 0; knobIdx < nKnobs; knobIdx++)
+		{
+			unsigned int seg;
+			double t;
+			int extrap;
+			StoredWgtSpline::Locate(sigmas[knobIdx], seg, t, extrap);
+
+			// beyond the ends, StoredWgtSpline::Eval() continues linearly.  written out in terms of the coefficients:
+			//   below:  c0 + c1 t
+			//   above:  (c0 + c1 + c2 + c3) + (c1 + 2 c2 + 3 c3)(t - 1)  =  c0 + c1 t + c2 (2t - 1) + c3 (3t - 2)
+			double segBasis[4] = {1, t, t*t, t*t*t};
+			if (extrap < 0)
+				segBasis[2] = segBasis[3] = 0;
+			else if (extrap > 0)
+			{
+				segBasis[2] = 2*t - 1;
+				segBasis[3] = 3*t - 2;
+			}
+
+			for (unsigned int power = 0; power < 4; power++)
+			{
+				basis[kStoredWgtSplineSize * knobIdx + 4 * seg + power] = segBasis[power];
+				keep[kStoredWgtSplineSize * knobIdx + 4 * seg + power] = -1;
+			}
+		}
+
+		ApplyMaskedCoeffs<kStoredWgtSplineSize>(splineCoeffs, nEvts, nKnobs, zero.data(), basis.data(), keep.data(), wgts, diag);
+	}
+}
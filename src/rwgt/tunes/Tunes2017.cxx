@@ -26,7 +26,7 @@ namespace novarwgt
 	// ------------------------------------------------------------------------------------
 	// first: systematics that will be included in the tune.
 	// see towards the bottom of this file for the actual tune object.
-	const std::unordered_set<const novarwgt::ISystKnob*> k2017GENIEKnobs
+	const novarwgt::SystKnobSet k2017GENIEKnobs
 	{
 		// BEWARE: this is NOT a list of ALL
 		// GENIE knobs; some of them are mutually exclusive
@@ -103,7 +103,7 @@ namespace novarwgt
 
 	//----------------------------------------------------------------------
 
-	const std::unordered_set<const novarwgt::ISystKnob*> k2017CustomKnobs
+	const novarwgt::SystKnobSet k2017CustomKnobs
 	{
 		//  (1) "Reduced" M_A uncertainty (as compared to GENIE M_A knob)
 		GetSystKnob<novarwgt::MAQEGenieReducedSyst2017>(),
@@ -169,15 +169,29 @@ namespace novarwgt
 
 	// ------------------------------------------------------------------------------------
 
+	// the CV weighters, each looked up once so that kCVTune2017 and kStaticCVTune2017 can't drift apart
+	namespace
+	{
+		// request old buggy behavior of RPA
+		const RPAWeightCCQE_2017 * const kRPAQEWgtr2017 = novarwgt::GetWeighter<RPAWeightCCQE_2017>("CV", novarwgt::kScNull, true, true, false);
+		// request older approximate version of nonres pi selection
+		const Nonres1PiWgt * const kNonres1piWgtr2017 = novarwgt::GetWeighter<Nonres1PiWgt>(true, false);
+		const EmpiricalMECWgt2017 * const kMECWgtr2017 = novarwgt::GetWeighter<EmpiricalMECWgt2017>();
+	}
+
 	/// CV MC tune used in 2017 analyses
 	const novarwgt::Tune kCVTune2017(
 	{
-		// request old buggy behavior of RPA
-		{ "RPA_QE",    novarwgt::GetWeighter<RPAWeightCCQE_2017>("CV", novarwgt::kScNull, true, true, false) },
-		{ "Nonres1pi", novarwgt::GetWeighter<Nonres1PiWgt>(true, false) },  // request older approximate version of nonres pi selection
-		{ "MEC",       novarwgt::GetWeighter<EmpiricalMECWgt2017>() },
+		{ "RPA_QE",    kRPAQEWgtr2017 },
+		{ "Nonres1pi", kNonres1piWgtr2017 },
+		{ "MEC",       kMECWgtr2017 },
 		},
 		k2017GENIEKnobs | k2017CustomKnobs
 	);
 
+	//----------------------------------------------------------------------
+
+	/// Static version of kCVTune2017 (the same weighter objects)
+	const StaticCVTune2017_t kStaticCVTune2017(kRPAQEWgtr2017, kNonres1piWgtr2017, kMECWgtr2017);
+
 }
\ No newline at end of file
@@ -31,7 +31,7 @@ namespace novarwgt
 	// first: systematics that will be included in the tune.
 	// see towards the bottom of this file for the actual tune objects.
 
-	const std::unordered_set<const novarwgt::ISystKnob*> k2018GENIEKnobs
+	const novarwgt::SystKnobSet k2018GENIEKnobs
 	{
 		// BEWARE: this is NOT a list of ALL
 		// GENIE knobs; some of them are mutually exclusive
@@ -109,7 +109,7 @@ namespace novarwgt
 
 	//----------------------------------------------------------------------
 
-	const std::unordered_set<const novarwgt::ISystKnob*> k2018MECKnobs
+	const novarwgt::SystKnobSet k2018MECKnobs
 	{
 		GetSystKnob<novarwgt::MECQ0Q3RespSyst2018>(kNeutrino, false),
 		GetSystKnob<novarwgt::MECQ0Q3RespSyst2018>(kAntineutrino, false),
@@ -121,7 +121,7 @@ namespace novarwgt
 
 	//----------------------------------------------------------------------
 
-	const std::unordered_set<const novarwgt::ISystKnob*> k2018MECKnobs_RPAFix
+	const novarwgt::SystKnobSet k2018MECKnobs_RPAFix
 	{
 		GetSystKnob<novarwgt::MECQ0Q3RespSyst2018>(kNeutrino, true),
 		GetSystKnob<novarwgt::MECQ0Q3RespSyst2018>(kAntineutrino, true),
@@ -134,7 +134,7 @@ namespace novarwgt
 	//----------------------------------------------------------------------
 
 	/// Other non-MEC custom NOvA knobs
-	const std::unordered_set<const novarwgt::ISystKnob*> k2018OtherCustomKnobs
+	const novarwgt::SystKnobSet k2018OtherCustomKnobs
 	{
 		//  (1) "Reduced" M_A uncertainty (as compared to GENIE M_A knob)
 		GetSystKnob<novarwgt::MAQEGenieReducedSyst2018>(),
@@ -199,17 +199,38 @@ namespace novarwgt
 
 	// ------------------------------------------------------------------------------------
 
+	// the CV weighters, each looked up once so that the Tune and StaticTune versions below can't drift apart
+	namespace
+	{
+		const MAQEWeight_2018 * const kMAQEWgtr2018 = novarwgt::GetWeighter<MAQEWeight_2018>();
+
+		// request old buggy apply-to-hydrogen behavior for both RPA knobs,
+		// as well as weights for 2.10 GENIE (since we didn't know about the difference at the time)
+		const RPAWeightCCQE_2017 * const kRPAQEWgtr2018 = novarwgt::GetWeighter<RPAWeightCCQE_2017>("CV", novarwgt::kScQuasiElastic, true, false, true);
+		const RPAWeightQ2_2017 * const kRPARESWgtr2018 = novarwgt::GetWeighter<RPAWeightQ2_2017>(novarwgt::kRxnCC, novarwgt::kScResonant, true);
+
+		// same, after the Hydrogen RPA bug fix
+		const RPAWeightCCQE_2017 * const kRPAQEWgtr2018_RPAfix = novarwgt::GetWeighter<RPAWeightCCQE_2017>("CV", novarwgt::kScQuasiElastic, false, false, true);
+		const RPAWeightQ2_2017 * const kRPARESWgtr2018_RPAfix = novarwgt::GetWeighter<RPAWeightQ2_2017>(novarwgt::kRxnCC, novarwgt::kScResonant);
+
+		// request version with typo in weight (0.41 instead of correct 0.43)
+		const Nonres1PiWgt * const kNonres1piWgtr2018 = novarwgt::GetWeighter<Nonres1PiWgt>(false, true);
+
+		const HighWDISWgt_2018 * const kHighWWgtr2018 = novarwgt::GetWeighter<HighWDISWgt_2018>();
+
+		const EmpiricalMECWgt2018 * const kMECWgtr2018 = novarwgt::GetWeighter<EmpiricalMECWgt2018>();
+		const EmpiricalMECWgt2018RPAFix * const kMECWgtr2018_RPAfix = novarwgt::GetWeighter<EmpiricalMECWgt2018RPAFix>();
+	}
+
 	/// CV tune used for 2018 analysis
 	const novarwgt::Tune kCVTune2018(
 		{
-			{ "MA_QE",     novarwgt::GetWeighter<MAQEWeight_2018>() },
-			// request old buggy apply-to-hydrogen behavior for both RPA knobs,
-			// as well as weights for 2.10 GENIE (since we didn't know about the difference at the time)
-			{ "RPA_QE",    novarwgt::GetWeighter<RPAWeightCCQE_2017>("CV", novarwgt::kScQuasiElastic, true, false, true) },
-			{ "RPA_RES",   novarwgt::GetWeighter<RPAWeightQ2_2017>(novarwgt::kRxnCC, novarwgt::kScResonant, true) },
-			{ "Nonres1pi", novarwgt::GetWeighter<Nonres1PiWgt>(false, true) },  // request version with typo in weight (0.41 instead of correct 0.43)
-			{ "HighW",     novarwgt::GetWeighter<HighWDISWgt_2018>() },
-			{ "MEC",       novarwgt::GetWeighter<EmpiricalMECWgt2018>() },
+			{ "MA_QE",     kMAQEWgtr2018 },
+			{ "RPA_QE",    kRPAQEWgtr2018 },
+			{ "RPA_RES",   kRPARESWgtr2018 },
+			{ "Nonres1pi", kNonres1piWgtr2018 },
+			{ "HighW",     kHighWWgtr2018 },
+			{ "MEC",       kMECWgtr2018 },
 		},
 		k2018GENIEKnobs | k2018MECKnobs | k2018OtherCustomKnobs
 	);
@@ -220,12 +241,12 @@ namespace novarwgt
 	/// (but without update to fixed RPA correction for GENIE 2.12)
 	const novarwgt::Tune kCVTune2018_RPAfix(
 		{
-			{ "MA_QE",     novarwgt::GetWeighter<MAQEWeight_2018>() },
-			{ "RPA_QE",    novarwgt::GetWeighter<RPAWeightCCQE_2017>("CV", novarwgt::kScQuasiElastic, false, false, true) },
-			{ "RPA_RES",   novarwgt::GetWeighter<RPAWeightQ2_2017>(novarwgt::kRxnCC, novarwgt::kScResonant) },
-			{ "Nonres1pi", novarwgt::GetWeighter<Nonres1PiWgt>(false, true) },
-			{ "HighW",     novarwgt::GetWeighter<HighWDISWgt_2018>() },
-			{ "MEC",       novarwgt::GetWeighter<EmpiricalMECWgt2018RPAFix>() },
+			{ "MA_QE",     kMAQEWgtr2018 },
+			{ "RPA_QE",    kRPAQEWgtr2018_RPAfix },
+			{ "RPA_RES",   kRPARESWgtr2018_RPAfix },
+			{ "Nonres1pi", kNonres1piWgtr2018 },
+			{ "HighW",     kHighWWgtr2018 },
+			{ "MEC",       kMECWgtr2018_RPAfix },
 		},
 		k2018GENIEKnobs | k2018MECKnobs_RPAFix | k2018OtherCustomKnobs
 	);
@@ -236,13 +257,29 @@ namespace novarwgt
 	/// (and without correction to actual GENIE 2.12 RPA-CCQE weights)
 	const novarwgt::Tune kCVTune2018_RPAfix_noDIStweak(
 		{
-			{ "MA_QE",     novarwgt::GetWeighter<MAQEWeight_2018>() },
-			{ "RPA_QE",    novarwgt::GetWeighter<RPAWeightCCQE_2017>("CV", novarwgt::kScQuasiElastic, false, false, true) },
-			{ "RPA_RES",   novarwgt::GetWeighter<RPAWeightQ2_2017>(novarwgt::kRxnCC, novarwgt::kScResonant) },
-			{ "Nonres1pi", novarwgt::GetWeighter<Nonres1PiWgt>(false, true) },
-			{ "MEC",       novarwgt::GetWeighter<EmpiricalMECWgt2018RPAFix>() },
+			{ "MA_QE",     kMAQEWgtr2018 },
+			{ "RPA_QE",    kRPAQEWgtr2018_RPAfix },
+			{ "RPA_RES",   kRPARESWgtr2018_RPAfix },
+			{ "Nonres1pi", kNonres1piWgtr2018 },
+			{ "MEC",       kMECWgtr2018_RPAfix },
 		},
 		k2018GENIEKnobs | k2018MECKnobs_RPAFix | k2018OtherCustomKnobs
 	);
 
+	// ------------------------------------------------------------------------------------
+	// static versions of the above, built from the same weighter objects
+
+	const StaticCVTune2018_t kStaticCVTune2018(kMAQEWgtr2018, kRPAQEWgtr2018, kRPARESWgtr2018,
+	                                           kNonres1piWgtr2018, kHighWWgtr2018, kMECWgtr2018);
+
+	//----------------------------------------------------------------------
+
+	const StaticCVTune2018_RPAfix_t kStaticCVTune2018_RPAfix(kMAQEWgtr2018, kRPAQEWgtr2018_RPAfix, kRPARESWgtr2018_RPAfix,
+	                                                         kNonres1piWgtr2018, kHighWWgtr2018, kMECWgtr2018_RPAfix);
+
+	//----------------------------------------------------------------------
+
+	const StaticCVTune2018_RPAfix_noDIStweak_t kStaticCVTune2018_RPAfix_noDIStweak(kMAQEWgtr2018, kRPAQEWgtr2018_RPAfix, kRPARESWgtr2018_RPAfix,
+	                                                                             kNonres1piWgtr2018, kMECWgtr2018_RPAfix);
+
 }
\ No newline at end of file
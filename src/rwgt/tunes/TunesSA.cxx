@@ -13,12 +13,23 @@
 
 namespace novarwgt
 {
+	// the CV weighters, each looked up once so that kCVTuneSA and kStaticCVTuneSA can't drift apart
+	namespace
+	{
+		// request older approximate version of nonres pi selection
+		const Nonres1PiWgt * const kNonres1piWgtrSA = novarwgt::GetWeighter<Nonres1PiWgt>(true, false);
+		const Tufts2p2hWgtSA * const kMECWgtrSA = novarwgt::GetWeighter<Tufts2p2hWgtSA>();
+	}
+
 	const novarwgt::Tune kCVTuneSA(
 		{
-			{ "Nonres1pi", novarwgt::GetWeighter<Nonres1PiWgt>(true, false) },  // request older approximate version of nonres pi selection
-			{ "MEC",       novarwgt::GetWeighter<Tufts2p2hWgtSA>() },
+			{ "Nonres1pi", kNonres1piWgtrSA },
+			{ "MEC",       kMECWgtrSA },
 			},
 		{}  // we don't have the SA error budget implemented here
 	);
 
+	/// Static version of kCVTuneSA (the same weighter objects)
+	const StaticCVTuneSA_t kStaticCVTuneSA(kNonres1piWgtrSA, kMECWgtrSA);
+
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include "TLorentzVector.h"
 
@@ -71,16 +72,19 @@ int main()
 
 	auto testEventsIn = novarwgt::test::GetTestEvents();
 	decltype(testEventsIn) testEventsOut;
+	std::vector<std::unique_ptr<genie::EventRecord>> genieEvts;  // the converted records point to these, so they need to stick around
+	novarwgt::GenieEventConverter converter;
 	for (const auto & evtInPair : testEventsIn)
 	{
 		const auto & evt = evtInPair.second;
 		// this may look a little silly
 		// (converting novarwgt::EventRecords to the GENIE types and then back)
 		// but (assuming the ToGenieEvent() function in the internal tools is written correctly)
-		// it tests the ConvertGenieEvent() is working correctly...
-		auto genieEvt = novarwgt::internal::ToGenieEvent(evt.Event());
+		// it tests the GenieEventConverter is working correctly...
+		genieEvts.push_back(std::make_unique<genie::EventRecord>());
+		novarwgt::internal::ToGenieEvent(evt.Event(), *genieEvts.back());
 
-		auto newEvt = novarwgt::ConvertGenieEvent(&genieEvt, evt.Event().genieWeights);
+		auto newEvt = converter.Convert(genieEvts.back().get(), evt.Event().genieWeights);
 		testEventsOut.emplace( evtInPair.first,
 			novarwgt::test::TestEvent<novarwgt::EventRecord>(newEvt, evt.ExpectedWeight(), evt.Tune(), evt.ExpectedSysts()) );
 	}
@@ -13,11 +13,13 @@
 
 #include "NOvARwgt/rwgt/IWeightGenerator.h"
 
+#include "NOvARwgt/rwgt/genie/GenieSystKnob.h"
 #include "NOvARwgt/rwgt/genie/QE/RPAWeights.h"
 #include "NOvARwgt/rwgt/genie/DIS/Nonres1piWeights.h"
 
 #include <cassert>
 #include <iostream>
+#include <set>
 
 int main()
 {
@@ -42,5 +44,14 @@ int main()
 	// unfortunately still falls down on default arguments.  best we can do?
 //	assert(H == I);
 
+	// small integer-like arguments are where a weak hash combination collides
+	std::set<const novarwgt::GenieSystKnob*> genieKnobs;
+	for (int knob = novarwgt::kKnob_Null + 1; knob < novarwgt::kLastKnob; knob++)
+	{
+		for (auto interp : {novarwgt::GenieSystKnob::kLinearInterp, novarwgt::GenieSystKnob::kSplineInterp})
+			genieKnobs.insert(novarwgt::GetGenieSystKnob(novarwgt::ReweightKnob(knob), interp));
+	}
+	assert(genieKnobs.size() == 2 * std::size_t(novarwgt::kLastKnob - novarwgt::kKnob_Null - 1));
+
 	std::cout << "All Weighter hash tests passed successfully." << std::endl;
 }
\ No newline at end of file
@@ -7,10 +7,1196 @@
  *      Author: J. Wolcott <jwolcott@fnal.gov>
  */
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
 #include <iostream>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <vector>
 
+#include "TMemFile.h"
+#include "TTree.h"
+
+#include "NOvARwgt/interfaces/TTreeInterface.h"
+#include "NOvARwgt/rwgt/EventBatch.h"
 #include "NOvARwgt/rwgt/EventRecord.h"
+#include "NOvARwgt/rwgt/SpectrumAccumulator.h"
+#include "NOvARwgt/rwgt/Tune.h"
+#include "NOvARwgt/rwgt/UniverseThrower.h"
+#include "NOvARwgt/rwgt/WeightedSample.h"
+#include "NOvARwgt/rwgt/generic/NueNumuSysts.h"
+#include "NOvARwgt/rwgt/genie/GenieSystKnob.h"
+#include "NOvARwgt/rwgt/genie/StoredWgtInterpolation.h"
+#include "NOvARwgt/rwgt/genie/COH/COHSysts.h"
+#include "NOvARwgt/rwgt/genie/DIS/Nonres1piWeights.h"
+#include "NOvARwgt/rwgt/genie/DIS/NonresPiSysts.h"
+#include "NOvARwgt/rwgt/genie/MEC/EmpiricalMECSysts2017.h"
+#include "NOvARwgt/rwgt/genie/QE/RPASysts.h"
+#include "NOvARwgt/rwgt/tunes/Tunes2017.h"
+#include "NOvARwgt/rwgt/tunes/Tunes2018.h"
+#include "NOvARwgt/rwgt/tunes/TunesSA.h"
 #include "NOvARwgt/test/tests_common.h"
+#include "NOvARwgt/util/Exceptions.h"
+#include "NOvARwgt/util/Registry.ixx"
+
+namespace
+{
+	/// Knob that's 1 + sigma/2 down to -2.5 sigma and NaN below that, for every event
+	class NaNBelowSyst : public novarwgt::ISystKnob
+	{
+		public:
+			template <typename T>
+			explicit NaNBelowSyst(const novarwgt::IRegisterable::ClassID<T> & clID)
+				: ISystKnob(clID, "TestNaNBelow", {novarwgt::StoredGenSupportCfg(novarwgt::GenCfg::kGENIE_AllVersions)})
+			{}
+
+		protected:
+			double CalcWeight(double sigma, const novarwgt::EventRecord &, const novarwgt::InputVals &) const override
+			{
+				return (sigma < -2.5) ? std::numeric_limits<double>::quiet_NaN() : 1 + sigma / 2;
+			}
+	};
+
+	/// The test events that are expected to be weighted without complaint
+	std::vector<novarwgt::EventRecord> GoodTestEvents()
+	{
+		std::vector<novarwgt::EventRecord> evts;
+		for (const auto & testEvPair : novarwgt::test::GetTestEvents())
+		{
+			if (!testEvPair.second.ExpectedException())
+				evts.push_back(testEvPair.second.Event());
+		}
+		return evts;
+	}
+
+	/// Does every event in \a sample have the weight Tune::ShiftedEventWeight() gives it?
+	/// (Where that isn't a usable weight, WeightedSample gives 0 instead.)
+	bool CheckWeightedSample(const novarwgt::WeightedSample & sample,
+	                         const novarwgt::Tune & tune,
+	                         const std::vector<novarwgt::EventRecord> & evts,
+	                         const std::string & step)
+	{
+		std::vector<double> sigmas;
+		for (std::size_t knobIdx = 0; knobIdx < sample.KnobNames().size(); knobIdx++)
+			sigmas.push_back(sample.Sigma(knobIdx));
+
+		bool ok = true;
+		for (std::size_t evtIdx = 0; evtIdx < evts.size(); evtIdx++)
+		{
+			double expected = tune.ShiftedEventWeight(evts[evtIdx], sigmas);
+			if (!std::isfinite(expected))
+				expected = 0;
+			if (std::abs(sample.Weight(evtIdx) - expected) > 1e-9 * std::max(1., std::abs(expected)))
+			{
+				std::cerr << "WeightedSample (" << step << "): event " << evtIdx << " has weight " << sample.Weight(evtIdx)
+				          << ", expected " << expected << std::endl;
+				ok = false;
+			}
+		}
+		return ok;
+	}
+
+	/// WeightedSample must keep agreeing with Tune::ShiftedEventWeight() however the sigmas are moved around
+	bool TestWeightedSample()
+	{
+		std::cout << "Validating WeightedSample against Tune::ShiftedEventWeight()" << std::endl;
+
+		novarwgt::SystKnobSet knobs;
+		for (const auto & knob : novarwgt::GetDISnPionSystFamily().Members())
+			knobs.insert(knob);
+		const auto nanKnob = novarwgt::GetSystKnob<NaNBelowSyst>();
+		knobs.insert(nanKnob);
+		const novarwgt::Tune tune({}, knobs);
+
+		const auto dis1piKnobIdx = tune.FindKnob(novarwgt::kDIS_CC_1pi_nu_n_SystKnob->GetName()).idx;
+		const auto nanKnobIdx = tune.FindKnob(nanKnob->GetName()).idx;
+
+		const auto evts = GoodTestEvents();
+		novarwgt::WeightedSample sample(tune, evts);
+		bool ok = CheckWeightedSample(sample, tune, evts, "nominal");
+
+		// the low-W DIS knobs are 1 + sigma/2, so -2 sigma zeroes the event
+		sample.SetSigma(dis1piKnobIdx, -2);
+		ok = CheckWeightedSample(sample, tune, evts, "weight driven to 0") && ok;
+		sample.SetSigma(dis1piKnobIdx, 0.5);
+		ok = CheckWeightedSample(sample, tune, evts, "weight back from 0") && ok;
+
+		sample.SetSigma(nanKnobIdx, -3);
+		ok = CheckWeightedSample(sample, tune, evts, "NaN factor") && ok;
+		sample.SetSigma(nanKnobIdx, 1);
+		ok = CheckWeightedSample(sample, tune, evts, "back from NaN factor") && ok;
+
+		// enough steps (passing through 0 and NaN on the way) that the products get rebuilt along the way
+		for (unsigned int step = 0; step < 2500; step++)
+		{
+			const std::size_t knobIdx = (step % 2) ? nanKnobIdx : dis1piKnobIdx;
+			sample.SetSigma(knobIdx, -3 + 0.37 * (step % 17));
+		}
+		ok = CheckWeightedSample(sample, tune, evts, "after many updates") && ok;
+
+		return ok;
+	}
+
+	/// Evaluating the DISnPionSyst knobs as a family in Tune::ShiftedEventWeight() must give
+	/// the product of all their GetWeight()s (and throw where any of those would)
+	bool TestDISnPionFamily()
+	{
+		std::cout << "Validating the DISnPionSyst family against the individual knobs" << std::endl;
+
+		novarwgt::SystKnobSet knobs;
+		for (const auto & knob : novarwgt::GetDISnPionSystFamily().Members())
+			knobs.insert(knob);
+		const novarwgt::Tune tune({}, knobs);
+
+		// the test events themselves, plus copies from a generator the knobs don't support
+		std::vector<std::pair<std::string, novarwgt::EventRecord>> evts;
+		for (const auto & testEvPair : novarwgt::test::GetTestEvents())
+		{
+			evts.emplace_back(testEvPair.first, testEvPair.second.Event());
+			evts.emplace_back(testEvPair.first + " (GENIE v3)", testEvPair.second.Event());
+			evts.back().second.generatorVersion = {3, 0, 6};
+			evts.back().second.Finalize();
+		}
+
+		bool ok = true;
+		for (const auto & evtPair : evts)
+		{
+			const novarwgt::EventRecord & evt = evtPair.second;
+			for (unsigned int trial = 0; trial < 5; trial++)
+			{
+				std::vector<double> sigmas(tune.SystKnobs().size());
+				for (std::size_t knobIdx = 0; knobIdx < sigmas.size(); knobIdx++)
+					sigmas[knobIdx] = -2.5 + 0.31 * ((knobIdx * 7 + trial * 3) % 17);
+
+				double expected = 1, wgt = 0;
+				bool expectedThrew = false, threw = false;
+				try
+				{
+					for (std::size_t knobIdx = 0; knobIdx < sigmas.size(); knobIdx++)
+						expected *= tune.SystKnobs()[knobIdx]->GetWeight(sigmas[knobIdx], evt);
+				}
+				catch (std::exception &) { expectedThrew = true; }
+				try { wgt = tune.ShiftedEventWeight(evt, sigmas); }
+				catch (std::exception &) { threw = true; }
+
+				if (threw != expectedThrew)
+				{
+					std::cerr << "DISnPionSyst family: event '" << evtPair.first << "' " << (threw ? "threw" : "didn't throw")
+					          << " from ShiftedEventWeight(), but the knobs' GetWeight() " << (expectedThrew ? "did" : "didn't") << std::endl;
+					ok = false;
+				}
+				else if (!threw && std::abs(wgt - expected) > 1e-12 * std::max(1., std::abs(expected)))
+				{
+					std::cerr << "DISnPionSyst family: event '" << evtPair.first << "' has shifted weight " << wgt
+					          << ", but the product of the knobs' weights is " << expected << std::endl;
+					ok = false;
+				}
+			}
+		}
+		return ok;
+	}
+
+	/// Does \a evt's Classification() agree with the field-by-field tests the weighters made before it existed?
+	bool CheckClassification(const novarwgt::EventRecord & evt, const std::string & name)
+	{
+		const std::uint32_t cls = evt.Classification();
+		const bool isDIS = evt.reaction == novarwgt::kScDeepInelastic;
+		const bool badW = evt.W < 0 || std::isnan(evt.W);
+		const int npion = evt.npiplus + evt.npizero + evt.npiminus;
+
+		// {what, the old test, the mask test that replaced it}
+		const std::vector<std::tuple<std::string, bool, bool>> checks
+		{
+			// Nonres1PiWgt
+			std::make_tuple("low-W DIS nu", isDIS && !(evt.W > 1.7 || badW) && evt.nupdg >= 0,
+			                (cls & (novarwgt::kEvtDIS | novarwgt::kEvtLowW)) == (novarwgt::kEvtDIS | novarwgt::kEvtLowW) && !(cls & novarwgt::kEvtNubar)),
+			std::make_tuple("1 pion", npion == 1, bool(cls & novarwgt::kEvt1Pi)),
+			// HighWDISWgt_2018
+			std::make_tuple("high-W DIS nu", !badW && isDIS && evt.nupdg >= 0 && evt.W >= 1.7,
+			                (cls & (novarwgt::kEvtDIS | novarwgt::kEvtHighW)) == (novarwgt::kEvtDIS | novarwgt::kEvtHighW) && !(cls & novarwgt::kEvtNubar)),
+			// RPA weights
+			std::make_tuple("nue or numu", std::abs(evt.nupdg) == 12 || std::abs(evt.nupdg) == 14,
+			                bool(cls & (novarwgt::kEvtNuE | novarwgt::kEvtNuMu))),
+			std::make_tuple("hydrogen", evt.A == 1, bool(cls & novarwgt::kEvtFreeNucleon)),
+			std::make_tuple("CC", evt.isCC, bool(cls & novarwgt::kEvtCC)),
+			std::make_tuple("NC", !evt.isCC, bool(cls & novarwgt::kEvtNC)),
+			// DISnPionSyst
+			std::make_tuple("DIS", isDIS, bool(cls & novarwgt::kEvtDIS)),
+			std::make_tuple("struck nucleon", evt.struckNucl == 2212 || evt.struckNucl == 2112,
+			                bool(cls & (novarwgt::kEvtStruckProton | novarwgt::kEvtStruckNeutron))),
+			std::make_tuple("struck proton", evt.struckNucl == 2212, bool(cls & novarwgt::kEvtStruckProton)),
+			std::make_tuple("nubar", evt.nupdg < 0, bool(cls & novarwgt::kEvtNubar)),
+		};
+
+		bool ok = true;
+		for (const auto & check : checks)
+		{
+			if (std::get<1>(check) != std::get<2>(check))
+			{
+				std::cerr << "Classification(): '" << std::get<0>(check) << "' is " << std::get<2>(check)
+				          << " for " << name << ", but the field test says " << std::get<1>(check) << std::endl;
+				ok = false;
+			}
+		}
+		return ok;
+	}
+
+	/// EventRecord::Classification() must agree with the tests it replaced, on the test events and at the edges
+	bool TestClassification()
+	{
+		std::cout << "Validating EventRecord::Classification() against the field-by-field tests" << std::endl;
+
+		bool ok = true;
+		for (const auto & testEvPair : novarwgt::test::GetTestEvents())
+			ok = CheckClassification(testEvPair.second.Event(), "test event '" + testEvPair.first + "'") && ok;
+
+		// each record is checked both before Finalize(), when it's worked out on the fly, and after, when it's stored
+		novarwgt::EventRecord base;
+
+		const double Ws[] = {-1, 0, 0.5, std::nextafter(1.7, 0.), 1.7, std::nextafter(1.7, 2.), 3, std::numeric_limits<double>::quiet_NaN()};
+		const int nupdgs[] = {12, -12, 14, -14, 16, -16, 0};
+		const novarwgt::ReactionType reactions[] = {novarwgt::kScQuasiElastic, novarwgt::kScResonant, novarwgt::kScDeepInelastic,
+		                                            novarwgt::kScCoherent, novarwgt::kScMEC};
+		// (pi+, pi0, pi-), including unknown (negative) counts
+		const int pions[][3] = {{0, 0, 0}, {1, 0, 0}, {0, 0, 1}, {1, 1, 0}, {1, 1, 1}, {3, 1, 0}, {-1, 0, 0}, {-1, 2, 0}, {-1, -1, -1}};
+		const int As[] = {1, 12};
+		const int struckNucls[] = {2212, 2112, 0};
+		for (const double W : Ws)
+		{
+			for (const int nupdg : nupdgs)
+			{
+				for (const auto reaction : reactions)
+				{
+					for (const auto & npi : pions)
+					{
+						for (const bool isCC : {true, false})
+						{
+							for (const int A : As)
+							{
+								for (const int struckNucl : struckNucls)
+								{
+									novarwgt::EventRecord evt(base);
+									evt.W = W;
+									evt.nupdg = nupdg;
+									evt.reaction = reaction;
+									evt.npiplus = npi[0];
+									evt.npizero = npi[1];
+									evt.npiminus = npi[2];
+									evt.isCC = isCC;
+									evt.A = A;
+									evt.struckNucl = struckNucl;
+									const std::string name = "W=" + std::to_string(W) + " nupdg=" + std::to_string(nupdg)
+									                         + " rxn=" + std::to_string(int(reaction))
+									                         + " npi=" + std::to_string(npi[0]) + "," + std::to_string(npi[1]) + "," + std::to_string(npi[2])
+									                         + " CC=" + std::to_string(isCC) + " A=" + std::to_string(A)
+									                         + " struck=" + std::to_string(struckNucl);
+									if (!CheckClassification(evt, name))
+										ok = false;
+									evt.Finalize();
+									if (!CheckClassification(evt, name + " (finalized)"))
+										ok = false;
+								}
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// both W bits right at the boundary, where both the low- and high-W DIS weights have always applied
+		novarwgt::EventRecord atBoundary(base);
+		atBoundary.reaction = novarwgt::kScDeepInelastic;
+		atBoundary.W = 1.7;
+		atBoundary.Finalize();
+		if ((atBoundary.Classification() & (novarwgt::kEvtLowW | novarwgt::kEvtHighW)) != (novarwgt::kEvtLowW | novarwgt::kEvtHighW))
+		{
+			std::cerr << "Classification(): W = 1.7 should be both low and high W" << std::endl;
+			ok = false;
+		}
+
+		return ok;
+	}
+
+	/// The derived quantities of a finalized record must follow the fields when they're changed afterwards
+	/// (the kinematics straight away, Classification() once the record is finalized again)
+	bool TestModifiedRecord()
+	{
+		std::cout << "Validating the derived quantities of records modified after Finalize()" << std::endl;
+
+		bool ok = true;
+		auto check = [&ok](const std::string & what, double val, double expected)
+		{
+			if (std::abs(val - expected) > 1e-12 * std::max(1., std::abs(expected)))
+			{
+				std::cerr << "Modified record: " << what << " is " << val << ", expected " << expected << std::endl;
+				ok = false;
+			}
+		};
+
+		for (const auto & testEvPair : novarwgt::test::GetTestEvents())
+		{
+			novarwgt::EventRecord evt(testEvPair.second.Event());
+			evt.Finalize();
+
+			// a DIS event with different kinematics, as if the record were refilled by hand
+			evt.q = {0.4, 0.3, 1.2, 0.9};
+			evt.W = 2.5;
+			evt.reaction = novarwgt::kScDeepInelastic;
+
+			check("q0() for '" + testEvPair.first + "'", evt.q0(), 0.9);
+			check("q3() for '" + testEvPair.first + "'", evt.q3(), 1.3);
+			check("Q2() for '" + testEvPair.first + "'", evt.Q2(), 1.3 * 1.3 - 0.9 * 0.9);
+			check("W2() for '" + testEvPair.first + "'", evt.W2(), 6.25);
+
+			evt.Finalize();
+			if ((evt.Classification() & (novarwgt::kEvtDIS | novarwgt::kEvtLowW | novarwgt::kEvtHighW))
+			    != (novarwgt::kEvtDIS | novarwgt::kEvtHighW))
+			{
+				std::cerr << "Modified record: Classification() for '" << testEvPair.first << "' doesn't say high-W DIS" << std::endl;
+				ok = false;
+			}
+		}
+
+		return ok;
+	}
+
+	/// Compare \a knob's GetWeightAndDerivative() with its GetWeight() and a finite-difference derivative
+	/// at each of \a points: {sigma, side}, where side says which difference to take
+	/// (0 = central; -1 or +1 = one-sided, at a kink, on the side the knob's derivative is defined from)
+	bool CheckDerivatives(const novarwgt::ISystKnob * knob, const novarwgt::EventRecord & evt, const std::string & evtName,
+	                      const std::vector<std::pair<double, int>> & points)
+	{
+		const double h = 1e-6;
+		bool ok = true;
+		for (const auto & point : points)
+		{
+			const double sigma = point.first;
+			const int side = point.second;
+			novarwgt::WeightAndDerivative wd;
+			double wgt, fd;
+			try
+			{
+				wd = knob->GetWeightAndDerivative(sigma, evt);
+				wgt = knob->GetWeight(sigma, evt);
+				if (side == 0)
+					fd = (knob->GetWeight(sigma + h, evt) - knob->GetWeight(sigma - h, evt)) / (2 * h);
+				else
+					fd = side * (knob->GetWeight(sigma + side * h, evt) - wgt) / h;
+			}
+			catch (novarwgt::UnsupportedGeneratorException &)
+			{
+				// not every knob goes with every test event's generator
+				return ok;
+			}
+
+			if (std::abs(wd.weight - wgt) > 1e-12 * std::max(1., std::abs(wgt))
+			    || std::abs(wd.derivative - fd) > 1e-5 * std::max(1., std::abs(fd)))
+			{
+				std::cerr << "GetWeightAndDerivative(): '" << knob->GetName() << "' on event '" << evtName << "' at " << sigma << " sigma gives {"
+				          << wd.weight << ", " << wd.derivative << "}, but GetWeight() gives " << wgt << " with slope " << fd << std::endl;
+				ok = false;
+			}
+		}
+		return ok;
+	}
+
+	/// The analytic derivatives of the affine knobs, RPARESSyst and the GENIE knobs must match finite differences
+	bool TestDerivatives()
+	{
+		std::cout << "Validating ISystKnob::GetWeightAndDerivative() against finite differences" << std::endl;
+
+		std::vector<std::pair<std::string, novarwgt::EventRecord>> evts;
+		for (const auto & testEvPair : novarwgt::test::GetTestEvents())
+		{
+			if (testEvPair.second.ExpectedException())
+				continue;
+			evts.emplace_back(testEvPair.first, testEvPair.second.Event());
+
+			// there's no coherent test event, so borrow the kinematics of the others
+			evts.emplace_back(testEvPair.first + " (as COH)", testEvPair.second.Event());
+			evts.back().second.reaction = novarwgt::kScCoherent;
+			evts.back().second.Finalize();
+		}
+
+		// the affine knobs: straight lines, so every point should do
+		std::vector<const novarwgt::ISystKnob*> affineKnobs
+		{
+			novarwgt::kCOHNormCCSystKnob, novarwgt::kCOHNormNCSystKnob,
+			novarwgt::kSimpleRadiativeCorrNueXsecSystKnob, novarwgt::kSimpleRadiativeCorrNuebarXsecSystKnob,
+			novarwgt::kMECEnuShapeSyst2017, novarwgt::kMECEnuShapeSyst2017_NuOnly, novarwgt::kMECEnuShapeSyst2017_NubarOnly,
+		};
+		for (const auto & knob : novarwgt::GetDISnPionSystFamily().Members())
+			affineKnobs.push_back(knob);
+		const std::vector<std::pair<double, int>> affinePoints{{-2.3, 0}, {-0.6, 0}, {0, 0}, {0.7, 0}, {1.4, 0}, {2.6, 0}};
+
+		// RPARESSyst is one-sided, linear up to 1 sigma and flat beyond (with a step up past 2 sigma for the kludge).
+		// its derivative at 0 is the slope above, at 1 the slope below
+		const std::vector<const novarwgt::RPARESSyst*> rpaResKnobs{novarwgt::kRPARESSyst2017, novarwgt::kRPARESSyst2018,
+		                                                            novarwgt::kRPARESSyst2018_ExtrapKludge, novarwgt::kRPARESSyst2019};
+		const std::vector<std::pair<double, int>> rpaResPoints{{-0.5, 0}, {0, +1}, {0.5, 0}, {1, -1}, {1.5, 0}, {2, -1}, {2.5, 0}};
+
+		bool ok = true;
+		for (const auto & evtPair : evts)
+		{
+			for (const auto & knob : affineKnobs)
+				ok = CheckDerivatives(knob, evtPair.second, evtPair.first, affinePoints) && ok;
+			for (const auto & knob : rpaResKnobs)
+				ok = CheckDerivatives(knob, evtPair.second, evtPair.first, rpaResPoints) && ok;
+		}
+
+		// GENIE knobs from stored tables.  the linear interpolation has kinks at the nodes,
+		// where its derivative is the slope above; the spline's is continuous everywhere
+		const std::vector<novarwgt::ReweightVals> tables{{0.8f, 0.9f, 1.1f, 1.3f}, {1.5f, 1.2f, 0.9f, 0.85f}, {0.9f, 1.2f, 1.1f, 0.7f}};
+		const std::vector<std::pair<double, int>> linearPoints{{-2.5, 0}, {-2, +1}, {-1.5, 0}, {-1, +1}, {-0.4, 0}, {0, +1},
+		                                                       {0.6, 0}, {1, +1}, {1.5, 0}, {2, +1}, {2.8, 0}};
+		const std::vector<std::pair<double, int>> splinePoints{{-2.5, 0}, {-2, 0}, {-1.5, 0}, {-1, 0}, {-0.4, 0}, {0.6, 0},
+		                                                       {1, 0}, {1.5, 0}, {2, 0}, {2.8, 0}};
+		for (std::size_t tableIdx = 0; tableIdx < tables.size(); tableIdx++)
+		{
+			novarwgt::EventRecord evt(evts.front().second);
+			evt.genieWeights[novarwgt::kKnob_MaCCQE] = tables[tableIdx];
+			const std::string name = "stored table " + std::to_string(tableIdx);
+			ok = CheckDerivatives(novarwgt::GetGenieSystKnob(novarwgt::kKnob_MaCCQE), evt, name, linearPoints) && ok;
+			ok = CheckDerivatives(novarwgt::GetGenieSystKnob(novarwgt::kKnob_MaCCQE, novarwgt::GenieSystKnob::kSplineInterp),
+			                      evt, name, splinePoints) && ok;
+		}
+
+		return ok;
+	}
+
+	/// The batch linear interpolation (bit masks and all) must give what interpolating each table on its own does
+	bool TestStoredWgtInterpolation()
+	{
+		std::cout << "Validating the batch stored-weight interpolation" << std::endl;
+
+		const float nan = std::numeric_limits<float>::quiet_NaN();
+		const float inf = std::numeric_limits<float>::infinity();
+		const std::vector<novarwgt::ReweightVals> tables
+		{
+			{0.8f, 0.9f, 1.1f, 1.3f},
+			{1.5f, 1.2f, 0.9f, 0.85f},
+			{nan, 0.9f, 1.1f, 1.2f},     // bad entries only matter where their coefficient isn't zero
+			{0.7f, 0.9f, 1.1f, nan},
+			{0.7f, -inf, 1.1f, 1.2f},
+			{0.7f, 0.9f, inf, 1.2f},
+			{nan, inf, 1.1f, 1.2f},      // NaN counts over infinite
+			{nan, nan, nan, nan},
+		};
+		const auto knob = novarwgt::GetGenieSystKnob(novarwgt::kKnob_MaCCQE);
+
+		bool ok = true;
+		for (const double sigma : {-3.6, -2., -1.5, -1., -0.3, 0., 0.4, 1., 1.5, 2., 2.7})
+		{
+			// two events' worth, so the row bookkeeping gets exercised too
+			std::vector<novarwgt::ReweightVals> batch(tables);
+			batch.insert(batch.end(), tables.rbegin(), tables.rend());
+			const std::size_t nKnobs = tables.size();
+			const std::vector<double> sigmas(nKnobs, sigma);
+			std::vector<double> wgts(batch.size());
+			novarwgt::StoredWgtDiagnostics diag;
+			novarwgt::InterpolateStoredWgts(batch.data(), 2, nKnobs, sigmas.data(), wgts.data(), &diag);
+
+			novarwgt::StoredWgtDiagnostics expectedDiag;
+			for (std::size_t idx = 0; idx < batch.size(); idx++)
+			{
+				const double expected = novarwgt::InterpolateStoredWgt(novarwgt::StoredWgtCoeffs::ForSigma(sigma), batch[idx], expectedDiag);
+				if (std::abs(wgts[idx] - expected) > 1e-12 * std::max(1., std::abs(expected)))
+				{
+					std::cerr << "InterpolateStoredWgts(): table " << idx << " at " << sigma << " sigma gives " << wgts[idx]
+					          << ", but InterpolateStoredWgt() gives " << expected << std::endl;
+					ok = false;
+				}
+
+				// and through the knob, which also clamps
+				novarwgt::EventRecord ev;
+				ev.generator = novarwgt::kGENIE;
+				ev.generatorVersion = {2, 12, 2};
+				ev.genieWeights[novarwgt::kKnob_MaCCQE] = batch[idx];
+				const double knobWgt = knob->GetWeight(sigma, ev);
+				const double clamped = std::min(std::max(wgts[idx], 0.), 10.);
+				if (std::abs(knobWgt - clamped) > 1e-12 * std::max(1., clamped))
+				{
+					std::cerr << "InterpolateStoredWgts(): table " << idx << " at " << sigma << " sigma gives " << wgts[idx]
+					          << ", but GenieSystKnob gives " << knobWgt << std::endl;
+					ok = false;
+				}
+			}
+			if (diag.nNaN != expectedDiag.nNaN || diag.nInf != expectedDiag.nInf)
+			{
+				std::cerr << "InterpolateStoredWgts(): at " << sigma << " sigma counted " << diag.nNaN << " NaN and " << diag.nInf
+				          << " infinite weights, but InterpolateStoredWgt() counted " << expectedDiag.nNaN << " and " << expectedDiag.nInf << std::endl;
+				ok = false;
+			}
+		}
+
+		return ok;
+	}
+
+	/// Check the shape of StoredWgtSpline, its batch version, and the per-record cache of them
+	bool TestStoredWgtSplines()
+	{
+		std::cout << "Validating the stored-weight splines" << std::endl;
+
+		const std::vector<novarwgt::ReweightVals> tables
+		{
+			{0.8f, 0.9f, 1.1f, 1.3f},    // rising
+			{1.5f, 1.2f, 0.9f, 0.85f},   // falling
+			{0.9f, 1.2f, 1.1f, 0.7f},    // peaked
+			{1.0f, 1.0f, 1.0f, 1.0f},    // flat
+			{0.5f, 1.0f, 1.0f, 1.6f},    // flat in the middle
+			{0.2f, 0.3f, 4.0f, 4.1f},    // steep enough for the limiter to kick in
+		};
+
+		bool ok = true;
+		auto fail = [&ok](std::size_t tableIdx, const std::string & what)
+		{
+			std::cerr << "StoredWgtSpline for table " << tableIdx << ": " << what << std::endl;
+			ok = false;
+		};
+		auto close = [](double a, double b) { return std::abs(a - b) <= 1e-6 * std::max(1., std::abs(b)); };
+
+		for (std::size_t tableIdx = 0; tableIdx < tables.size(); tableIdx++)
+		{
+			const auto & vals = tables[tableIdx];
+			const novarwgt::StoredWgtSpline spline(vals);
+			const double nodes[5] = {vals.minus2sigma, vals.minus1sigma, 1, vals.plus1sigma, vals.plus2sigma};
+
+			// through the nodes
+			for (int node = 0; node < 5; node++)
+			{
+				if (!close(spline.Eval(node - 2.), nodes[node]))
+					fail(tableIdx, "misses the node at " + std::to_string(node - 2) + " sigma");
+			}
+
+			// monotone between them, and never outside the range of the two ends
+			for (unsigned int seg = 0; seg < 4; seg++)
+			{
+				const double lo = std::min(nodes[seg], nodes[seg+1]);
+				const double hi = std::max(nodes[seg], nodes[seg+1]);
+				const double dir = (nodes[seg+1] > nodes[seg]) ? 1 : ((nodes[seg+1] < nodes[seg]) ? -1 : 0);
+				double prev = nodes[seg];
+				for (int step = 1; step <= 100; step++)
+				{
+					const double val = spline.Eval(seg - 2. + step / 100.);
+					if (val < lo - 1e-6 || val > hi + 1e-6 || (val - prev) * dir < -1e-6 || (dir == 0 && !close(val, prev)))
+					{
+						fail(tableIdx, "isn't monotone between " + std::to_string(int(seg) - 2) + " and " + std::to_string(int(seg) - 1) + " sigma");
+						break;
+					}
+					prev = val;
+				}
+			}
+
+			// continuous first derivative at the interior nodes...
+			for (unsigned int seg = 0; seg < 3; seg++)
+			{
+				if (!close(spline.Derivative(seg, 1., 0), spline.Derivative(seg + 1, 0., 0)))
+					fail(tableIdx, "has a kink at " + std::to_string(int(seg) - 1) + " sigma");
+			}
+
+			// ... and straight lines beyond the ends, continuing the end slopes
+			const double slopeLo = spline.Derivative(0, 0., 0);
+			const double slopeHi = spline.Derivative(3, 1., 0);
+			for (const double dist : {0.25, 1., 3.7})
+			{
+				if (!close(spline.Eval(-2 - dist), nodes[0] - dist * slopeLo) || !close(spline.Derivative(-2 - dist), slopeLo))
+					fail(tableIdx, "doesn't extrapolate linearly to " + std::to_string(-2 - dist) + " sigma");
+				if (!close(spline.Eval(2 + dist), nodes[4] + dist * slopeHi) || !close(spline.Derivative(2 + dist), slopeHi))
+					fail(tableIdx, "doesn't extrapolate linearly to " + std::to_string(2 + dist) + " sigma");
+			}
+		}
+
+		// the batch kernel, on the tables above plus some bad ones, as one event's row of knobs
+		std::vector<novarwgt::ReweightVals> batchTables(tables);
+		batchTables.push_back({std::numeric_limits<float>::quiet_NaN(), 0.9f, 1.1f, 1.2f});
+		batchTables.push_back({0.9f, 0.95f, 1.1f, std::numeric_limits<float>::infinity()});
+		batchTables.push_back({0.9f, -std::numeric_limits<float>::infinity(), 1.1f, 1.2f});
+		std::vector<float> splineCoeffs(batchTables.size() * novarwgt::kStoredWgtSplineSize);
+		novarwgt::BuildStoredWgtSplines(batchTables.data(), batchTables.size(), splineCoeffs.data());
+		for (const double sigma : {-4.3, -2., -1.7, -1., -0.2, 0., 0.5, 1., 1.99, 2., 3.1})
+		{
+			const std::vector<double> sigmas(batchTables.size(), sigma);
+			std::vector<double> wgts(batchTables.size());
+			novarwgt::StoredWgtDiagnostics diag;
+			novarwgt::InterpolateStoredWgtSplines(splineCoeffs.data(), 1, batchTables.size(), sigmas.data(), wgts.data(), &diag);
+			for (std::size_t tableIdx = 0; tableIdx < batchTables.size(); tableIdx++)
+			{
+				if (!close(wgts[tableIdx], novarwgt::StoredWgtSpline(batchTables[tableIdx]).Eval(sigma)))
+					fail(tableIdx, "batch kernel gives " + std::to_string(wgts[tableIdx]) + " at " + std::to_string(sigma) + " sigma");
+			}
+			if (diag.nNaN != 1 || diag.nInf != 2)
+				fail(0, "batch kernel counted " + std::to_string(diag.nNaN) + " NaN and " + std::to_string(diag.nInf) + " infinite splines");
+		}
+
+		// the splines records carry are only the ones that were asked for, and only while the table is unchanged
+		novarwgt::EventRecord ev;
+		ev.genieWeights[novarwgt::kKnob_MaCCQE] = tables[0];
+		ev.genieWeights[novarwgt::kKnob_MaCCRES] = tables[1];
+		if (ev.genieWeights.Spline(novarwgt::kKnob_MaCCQE))
+			fail(0, "record has a spline nobody asked for");
+		ev.genieWeights.BuildSplines({novarwgt::kKnob_MaCCQE});
+		const novarwgt::EventRecord evCopy(ev);
+		const novarwgt::StoredWgtSpline * cached = evCopy.genieWeights.Spline(novarwgt::kKnob_MaCCQE);
+		if (!cached || !close(cached->Eval(0.7), novarwgt::StoredWgtSpline(tables[0]).Eval(0.7)))
+			fail(0, "record didn't keep the requested spline");
+		if (evCopy.genieWeights.Spline(novarwgt::kKnob_MaCCRES))
+			fail(1, "record has a spline nobody asked for");
+		ev.genieWeights[novarwgt::kKnob_MaCCQE] = tables[2];
+		if (ev.genieWeights.Spline(novarwgt::kKnob_MaCCQE))
+			fail(2, "record's spline wasn't invalidated when its table changed");
+
+		return ok;
+	}
+
+	/// Does \a staticTune weight every event (or refuse to) exactly as \a tune does?
+	template <typename StaticTuneT>
+	bool CheckStaticTune(const StaticTuneT & staticTune, const novarwgt::Tune & tune,
+	                     const std::vector<novarwgt::EventRecord> & evts, const std::string & name)
+	{
+		bool ok = true;
+		for (std::size_t evtIdx = 0; evtIdx < evts.size(); evtIdx++)
+		{
+			double expected = 0, wgt = 0;
+			std::string expectedErr, err;
+			try { expected = tune.EventWeight(evts[evtIdx]); }
+			catch (std::exception & e) { expectedErr = e.what(); }
+			try { wgt = staticTune.EventWeight(evts[evtIdx]); }
+			catch (std::exception & e) { err = e.what(); }
+
+			// (which weighter complains first may differ, so only ask whether both did)
+			if (err.empty() != expectedErr.empty())
+			{
+				std::cerr << name << ": event " << evtIdx << " threw '" << err << "', but the Tune threw '" << expectedErr << "'" << std::endl;
+				ok = false;
+			}
+			// (the Tune may multiply the factors in a different order, so allow for rounding)
+			else if (err.empty() && !(std::abs(wgt - expected) <= 1e-12 * std::max(1., std::abs(expected)))
+			         && !(std::isnan(wgt) && std::isnan(expected)))
+			{
+				std::cerr << name << ": event " << evtIdx << " has weight " << wgt << ", but the Tune gives " << expected << std::endl;
+				ok = false;
+			}
+		}
+		return ok;
+	}
+
+	/// The StaticTune versions of the shipped tunes must agree with the Tune versions
+	bool TestStaticTunes()
+	{
+		std::cout << "Validating the static tunes against their Tune counterparts" << std::endl;
+
+		const auto evts = GoodTestEvents();
+		bool ok = CheckStaticTune(novarwgt::kStaticCVTune2017, novarwgt::kCVTune2017, evts, "kStaticCVTune2017");
+		ok = CheckStaticTune(novarwgt::kStaticCVTune2018, novarwgt::kCVTune2018, evts, "kStaticCVTune2018") && ok;
+		ok = CheckStaticTune(novarwgt::kStaticCVTune2018_RPAfix, novarwgt::kCVTune2018_RPAfix, evts, "kStaticCVTune2018_RPAfix") && ok;
+		ok = CheckStaticTune(novarwgt::kStaticCVTune2018_RPAfix_noDIStweak, novarwgt::kCVTune2018_RPAfix_noDIStweak,
+		                     evts, "kStaticCVTune2018_RPAfix_noDIStweak") && ok;
+		ok = CheckStaticTune(novarwgt::kStaticCVTuneSA, novarwgt::kCVTuneSA, evts, "kStaticCVTuneSA") && ok;
+
+		return ok;
+	}
+
+	/// UniverseThrower: the throws must be reproducible and have the requested covariance,
+	/// and each universe's weight must be the CV weight times every knob's GetWeight() at that universe's sigma
+	bool TestUniverseThrower()
+	{
+		std::cout << "Validating UniverseThrower" << std::endl;
+
+		novarwgt::SystKnobSet knobs;
+		for (const auto & knob : novarwgt::GetDISnPionSystFamily().Members())
+			knobs.insert(knob);
+		knobs.insert(novarwgt::kCOHNormCCSystKnob);
+		knobs.insert(novarwgt::kSimpleRadiativeCorrNueXsecSystKnob);
+		knobs.insert(novarwgt::kRPARESSyst2018);
+		knobs.insert(novarwgt::GetGenieSystKnob(novarwgt::kKnob_MaCCQE));
+		const novarwgt::Tune tune({{"Nonres1pi", novarwgt::kNonres1PiWgt}}, knobs);
+		const std::size_t nKnobs = tune.KnobNames().size();
+
+		bool ok = true;
+
+		// the same seed must give the same universes, and the first N mustn't depend on how many are thrown
+		{
+			const novarwgt::UniverseThrower universes(tune, 100, 12345);
+			const novarwgt::UniverseThrower again(tune, 100, 12345);
+			const novarwgt::UniverseThrower more(tune, 250, 12345);
+			const novarwgt::UniverseThrower other(tune, 100, 54321);
+			bool differs = false;
+			for (std::size_t univIdx = 0; univIdx < universes.NUniverses(); univIdx++)
+			{
+				for (std::size_t knobIdx = 0; knobIdx < nKnobs; knobIdx++)
+				{
+					const double sigma = universes.Sigma(univIdx, knobIdx);
+					if (again.Sigma(univIdx, knobIdx) != sigma || more.Sigma(univIdx, knobIdx) != sigma)
+					{
+						std::cerr << "UniverseThrower: seed 12345 gives different sigmas for knob " << knobIdx << " in universe " << univIdx << std::endl;
+						ok = false;
+					}
+					differs = differs || other.Sigma(univIdx, knobIdx) != sigma;
+				}
+			}
+			if (!differs)
+			{
+				std::cerr << "UniverseThrower: seeds 12345 and 54321 give the same universes" << std::endl;
+				ok = false;
+			}
+		}
+
+		// correlated throws must reproduce the covariance they were given
+		// (rho^|i - j|, with a variance that differs between knobs, is positive definite for any number of knobs)
+		{
+			std::vector<double> covariance(nKnobs * nKnobs);
+			for (std::size_t row = 0; row < nKnobs; row++)
+			{
+				for (std::size_t col = 0; col < nKnobs; col++)
+				{
+					const double scale = std::sqrt((1 + 0.1 * (row % 4)) * (1 + 0.1 * (col % 4)));
+					covariance[row * nKnobs + col] = scale * std::pow(0.6, std::abs(int(row) - int(col)));
+				}
+			}
+
+			const std::size_t nUniverses = 20000;
+			const novarwgt::UniverseThrower universes(tune, nUniverses, 2026, covariance);
+			for (std::size_t row = 0; row < nKnobs; row++)
+			{
+				for (std::size_t col = 0; col <= row; col++)
+				{
+					double sum = 0;
+					for (std::size_t univIdx = 0; univIdx < nUniverses; univIdx++)
+						sum += universes.Sigma(univIdx, row) * universes.Sigma(univIdx, col);
+					// the sampling error is about sqrt(2 / nUniverses) ~ 0.01
+					const double cov = sum / nUniverses;
+					if (std::abs(cov - covariance[row * nKnobs + col]) > 0.05)
+					{
+						std::cerr << "UniverseThrower: covariance of knobs " << row << " and " << col << " is " << cov
+						          << ", expected " << covariance[row * nKnobs + col] << std::endl;
+						ok = false;
+					}
+				}
+			}
+
+			auto asymmetric = covariance;
+			asymmetric[1] += 0.1;
+			auto notPosDef = covariance;
+			notPosDef[0] = -1;
+			const std::vector<std::pair<std::string, std::vector<double>>> badCovs
+			{
+				{"asymmetric", asymmetric}, {"not positive definite", notPosDef}, {"wrong size", std::vector<double>(nKnobs)},
+			};
+			for (const auto & badCov : badCovs)
+			{
+				bool threw = false;
+				try
+				{
+					novarwgt::UniverseThrower(tune, 10, 2026, badCov.second);
+				}
+				catch (std::runtime_error &)
+				{
+					threw = true;
+				}
+				if (!threw)
+				{
+					std::cerr << "UniverseThrower: accepted a covariance matrix that's " << badCov.first << std::endl;
+					ok = false;
+				}
+			}
+		}
+
+		// every universe's weight is the CV weight times each knob's own weight at the universe's sigma
+		{
+			const novarwgt::UniverseThrower universes(tune, 50, 777);
+			std::vector<double> wgts(universes.NUniverses());
+			for (const auto & testEvPair : novarwgt::test::GetTestEvents())
+			{
+				if (testEvPair.second.ExpectedException())
+					continue;
+
+				// with a stored table, so the GENIE knob doesn't need GENIE
+				novarwgt::EventRecord evt(testEvPair.second.Event());
+				evt.genieWeights[novarwgt::kKnob_MaCCQE] = {0.8f, 0.9f, 1.15f, 1.2f};
+
+				bool threw = false;
+				try
+				{
+					universes.EventWeights(evt, wgts.data());
+				}
+				catch (std::exception &)
+				{
+					threw = true;
+				}
+
+				for (std::size_t univIdx = 0; univIdx < universes.NUniverses(); univIdx++)
+				{
+					double expected = std::numeric_limits<double>::quiet_NaN();
+					bool expectedThrew = false;
+					try
+					{
+						expected = tune.EventWeight(evt);
+						for (std::size_t knobIdx = 0; knobIdx < nKnobs; knobIdx++)
+							expected *= tune.SystKnobs()[knobIdx]->GetWeight(universes.Sigma(univIdx, knobIdx), evt);
+					}
+					catch (std::exception &)
+					{
+						expectedThrew = true;
+					}
+
+					if (threw != expectedThrew)
+					{
+						std::cerr << "UniverseThrower: EventWeights() " << (threw ? "threw" : "didn't throw") << " for '" << testEvPair.first
+						          << "', but GetWeight() " << (expectedThrew ? "did" : "didn't") << std::endl;
+						ok = false;
+						break;
+					}
+					if (threw)
+						break;
+					if (std::abs(wgts[univIdx] - expected) > 1e-12 * std::max(1., std::abs(expected)))
+					{
+						std::cerr << "UniverseThrower: '" << testEvPair.first << "' has weight " << wgts[univIdx] << " in universe " << univIdx
+						          << ", but the product of GetWeight()s is " << expected << std::endl;
+						ok = false;
+					}
+				}
+			}
+		}
+
+		return ok;
+	}
+
+	/// Copy \a evts into the columns of \a batch (which takes its generator from the first one)
+	void FillBatch(const std::vector<novarwgt::EventRecord> & evts, novarwgt::EventBatch & batch)
+	{
+		batch.resize(evts.size(), novarwgt::kLastKnob);
+		if (!evts.empty())
+		{
+			batch.generator = evts.front().generator;
+			batch.generatorVersion = evts.front().generatorVersion;
+			batch.generatorConfigStr = evts.front().generatorConfigStr;
+		}
+
+		for (std::size_t evtIdx = 0; evtIdx < evts.size(); evtIdx++)
+		{
+			const auto & evt = evts[evtIdx];
+			batch.nupdg[evtIdx] = evt.nupdg;
+			batch.isCC[evtIdx] = evt.isCC;
+			batch.reaction[evtIdx] = evt.reaction;
+			batch.struckNucl[evtIdx] = evt.struckNucl;
+			batch.Enu[evtIdx] = evt.Enu;
+			batch.q0[evtIdx] = evt.q0();
+			batch.q3[evtIdx] = evt.q3();
+			batch.y[evtIdx] = evt.y;
+			batch.W[evtIdx] = evt.W;
+			batch.A[evtIdx] = evt.A;
+			batch.npiplus[evtIdx] = evt.npiplus;
+			batch.npizero[evtIdx] = evt.npizero;
+			batch.npiminus[evtIdx] = evt.npiminus;
+			batch.expectNoWeights[evtIdx] = evt.expectNoWeights;
+			for (std::size_t knobIdx = 0; knobIdx < batch.nGenieKnobs; knobIdx++)
+			{
+				batch.genieWeightSet[evtIdx * batch.nGenieKnobs + knobIdx] = evt.genieWeights.IsSet(knobIdx);
+				if (evt.genieWeights.IsSet(knobIdx))
+					batch.genieWeights[evtIdx * batch.nGenieKnobs + knobIdx] = evt.genieWeights[knobIdx];
+			}
+		}
+	}
+
+	/// SpectrumAccumulator must give bit-for-bit the same spectra however many threads it uses,
+	/// and the same spectra (up to rounding) as weighting the events one by one
+	bool TestSpectrumAccumulator()
+	{
+		std::cout << "Validating SpectrumAccumulator" << std::endl;
+
+		novarwgt::SystKnobSet knobs;
+		for (const auto & knob : novarwgt::GetDISnPionSystFamily().Members())
+			knobs.insert(knob);
+		knobs.insert(novarwgt::kCOHNormCCSystKnob);
+		knobs.insert(novarwgt::kRPARESSyst2018);
+		knobs.insert(novarwgt::GetGenieSystKnob(novarwgt::kKnob_MaCCQE));
+		const novarwgt::Tune tune({{"Nonres1pi", novarwgt::kNonres1PiWgt}}, knobs);
+		const std::vector<novarwgt::KnobShift> shifts
+		{
+			{"MaCCQE", -1}, {"MaCCQE", 1.5},
+			{novarwgt::kDIS_CC_1pi_nu_n_SystKnob->GetName(), 1}, {novarwgt::kDIS_NC_1pi_nu_n_SystKnob->GetName(), -0.7},
+			{novarwgt::kRPARESSyst2018->GetName(), 0.5},
+		};
+
+		// enough events for several chunks (and several waves of them), spread over the bins.
+		// the batch has one generator version for everything, which all the knobs support
+		std::vector<novarwgt::EventRecord> evts;
+		const auto goodEvts = GoodTestEvents();
+		for (std::size_t copyIdx = 0; evts.size() < 20 * novarwgt::SpectrumAccumulator::kChunkSize + 17; copyIdx++)
+		{
+			for (const auto & goodEvt : goodEvts)
+			{
+				novarwgt::EventRecord evt(goodEvt);
+				evt.Enu *= 1 + 0.002 * (copyIdx % 500);
+				evt.genieWeights[novarwgt::kKnob_MaCCQE] = {0.8f, 0.9f + 0.0001f * (copyIdx % 100), 1.15f, 1.2f};
+				evts.push_back(evt);
+			}
+		}
+		novarwgt::EventBatch batch;
+		FillBatch(evts, batch);
+
+		// some events fall outside the bins, and aren't filled at all
+		const std::size_t nBins = 8;
+		auto binFn = [](const novarwgt::EventRecord & evt) { return int(evt.Enu / 0.5) - 1; };
+
+		novarwgt::SpectrumAccumulator serial(tune, nBins, binFn, shifts);
+		serial.Accumulate(batch, 1);
+
+		bool ok = true;
+		for (const unsigned int nThreads : {2u, 3u, 8u})
+		{
+			novarwgt::SpectrumAccumulator threaded(tune, nBins, binFn, shifts);
+			threaded.Accumulate(batch, nThreads);
+			for (std::size_t specIdx = 0; specIdx < serial.NSpectra(); specIdx++)
+			{
+				if (threaded.Contents(specIdx) != serial.Contents(specIdx) || threaded.SumW2(specIdx) != serial.SumW2(specIdx))
+				{
+					std::cerr << "SpectrumAccumulator: spectrum " << specIdx << " with " << nThreads << " threads isn't identical to the 1-thread one" << std::endl;
+					ok = false;
+				}
+			}
+		}
+
+		// the same thing an event at a time
+		std::vector<double> sumW(serial.NSpectra() * nBins, 0.), sumW2(serial.NSpectra() * nBins, 0.);
+		novarwgt::EventRecord evt;
+		for (std::size_t evtIdx = 0; evtIdx < batch.size(); evtIdx++)
+		{
+			batch.FillRecord(evtIdx, evt);
+			const int bin = binFn(evt);
+			if (bin < 0 || std::size_t(bin) >= nBins)
+				continue;
+
+			const double cvWgt = tune.EventWeight(evt);
+			for (std::size_t specIdx = 0; specIdx < serial.NSpectra(); specIdx++)
+			{
+				double wgt = cvWgt;
+				if (specIdx > 0)
+					wgt *= tune.Knob(tune.FindKnob(shifts[specIdx - 1].knob))->GetWeight(shifts[specIdx - 1].sigma, evt);
+				sumW[specIdx * nBins + bin] += wgt;
+				sumW2[specIdx * nBins + bin] += wgt * wgt;
+			}
+		}
+		for (std::size_t specIdx = 0; specIdx < serial.NSpectra(); specIdx++)
+		{
+			const auto contents = serial.Contents(specIdx);
+			const auto w2 = serial.SumW2(specIdx);
+			for (std::size_t bin = 0; bin < nBins; bin++)
+			{
+				const double expected = sumW[specIdx * nBins + bin];
+				const double expectedW2 = sumW2[specIdx * nBins + bin];
+				if (std::abs(contents[bin] - expected) > 1e-10 * std::max(1., std::abs(expected))
+				    || std::abs(w2[bin] - expectedW2) > 1e-10 * std::max(1., std::abs(expectedW2)))
+				{
+					std::cerr << "SpectrumAccumulator: spectrum " << specIdx << " bin " << bin << " is " << contents[bin] << " (sum w^2 " << w2[bin]
+					          << "), but weighting event by event gives " << expected << " (" << expectedW2 << ")" << std::endl;
+					ok = false;
+				}
+			}
+		}
+
+		return ok;
+	}
+
+	/// Does \a rec (read back from a tree) hold the same event as \a expected?
+	/// |q| is compared to \a q3Tol, since it may have been reconstructed from Q2.
+	bool CheckReadRecord(const novarwgt::EventRecord & rec, const novarwgt::EventRecord & expected, double q3Tol, const std::string & name)
+	{
+		bool ok = rec.generator == expected.generator && rec.generatorVersion == expected.generatorVersion
+		          && rec.nupdg == expected.nupdg && rec.isCC == expected.isCC && rec.reaction == expected.reaction
+		          && rec.struckNucl == expected.struckNucl && rec.A == expected.A
+		          && rec.npiplus == expected.npiplus && rec.npizero == expected.npizero && rec.npiminus == expected.npiminus
+		          && rec.Enu == expected.Enu && rec.q0() == expected.q0() && rec.y == expected.y && rec.W == expected.W
+		          && std::abs(rec.q3() - expected.q3()) <= q3Tol * std::max(1., expected.q3());
+		for (std::size_t knobIdx = 0; knobIdx < novarwgt::kLastKnob; knobIdx++)
+		{
+			if (rec.genieWeights.IsSet(knobIdx) != expected.genieWeights.IsSet(knobIdx))
+				ok = false;
+			else if (expected.genieWeights.IsSet(knobIdx))
+			{
+				// (some of the test events' tables have NaNs in them)
+				auto same = [](float a, float b) { return a == b || (std::isnan(a) && std::isnan(b)); };
+				const auto & vals = rec.genieWeights[knobIdx];
+				const auto & expVals = expected.genieWeights[knobIdx];
+				ok = ok && same(vals.minus2sigma, expVals.minus2sigma) && same(vals.minus1sigma, expVals.minus1sigma)
+				        && same(vals.plus1sigma, expVals.plus1sigma) && same(vals.plus2sigma, expVals.plus2sigma);
+			}
+		}
+
+		if (!ok)
+		{
+			std::cerr << "TTreeBatchReader: " << name << " doesn't match what was written.  Read:" << std::endl;
+			rec.PrintTo(std::cerr);
+			std::cerr << "Written:" << std::endl;
+			expected.PrintTo(std::cerr);
+		}
+		return ok;
+	}
+
+	/// Events written to a flat tree must come back out of TTreeBatchReader unchanged,
+	/// and weighting the batches must give the same weights as weighting the records
+	bool TestTTreeReader()
+	{
+		std::cout << "Validating TTreeBatchReader on a tree round trip" << std::endl;
+
+		// every event with the version the reader stamps on them, and an extra stored GENIE weight here and there
+		std::vector<novarwgt::EventRecord> evts;
+		const auto goodEvts = GoodTestEvents();
+		for (std::size_t copyIdx = 0; copyIdx < 3; copyIdx++)
+		{
+			for (const auto & goodEvt : goodEvts)
+			{
+				novarwgt::EventRecord evt(goodEvt);
+				evt.generator = novarwgt::kGENIE;
+				evt.generatorVersion = {2, 12, 2};
+				if (evts.size() % 3 == copyIdx && !evt.genieWeights.IsSet(novarwgt::kKnob_MaCCRES))
+					evt.genieWeights[novarwgt::kKnob_MaCCRES] = {1.3f, 1.1f, 0.95f, 0.9f + 0.01f * float(copyIdx)};
+				evt.Finalize();
+				evts.push_back(evt);
+			}
+		}
+
+		TMemFile file("novarwgt_ttree_test.root", "RECREATE");
+		file.cd();
+		auto tree = new TTree("truth", "truth");   // owned by the file
+
+		double Enu, Q2, q0, q3, W, y;
+		int mode, ccnc, pdg, hitnuc, npiplus, npizero, npiminus;
+		unsigned int tgtA;
+		std::vector<float> genieWgts(4 * novarwgt::kLastKnob);
+		tree->Branch("Enu", &Enu, "Enu/D");
+		tree->Branch("Q2", &Q2, "Q2/D");
+		tree->Branch("q0", &q0, "q0/D");
+		tree->Branch("q3", &q3, "q3/D");
+		tree->Branch("W", &W, "W/D");
+		tree->Branch("y", &y, "y/D");
+		tree->Branch("mode", &mode, "mode/I");
+		tree->Branch("ccnc", &ccnc, "ccnc/I");
+		tree->Branch("pdg", &pdg, "pdg/I");
+		tree->Branch("tgtA", &tgtA, "tgtA/i");
+		tree->Branch("hitnuc", &hitnuc, "hitnuc/I");
+		tree->Branch("npiplus", &npiplus, "npiplus/I");
+		tree->Branch("npizero", &npizero, "npizero/I");
+		tree->Branch("npiminus", &npiminus, "npiminus/I");
+		tree->Branch("genieWgts", genieWgts.data(), ("genieWgts[" + std::to_string(genieWgts.size()) + "]/F").c_str());
+		tree->SetAutoFlush(10);   // several baskets, so the bulk reads have to cross from one to the next
+
+		for (const auto & evt : evts)
+		{
+			Enu = evt.Enu;
+			Q2 = evt.Q2();
+			q0 = evt.q0();
+			q3 = evt.q3();
+			W = evt.W;
+			y = evt.y;
+			mode = evt.reaction;
+			ccnc = evt.isCC ? 0 : 1;
+			pdg = evt.nupdg;
+			tgtA = evt.A;
+			hitnuc = evt.struckNucl;
+			npiplus = evt.npiplus;
+			npizero = evt.npizero;
+			npiminus = evt.npiminus;
+			// knobs that aren't stored are all NaN
+			std::fill(genieWgts.begin(), genieWgts.end(), std::numeric_limits<float>::quiet_NaN());
+			for (std::size_t knobIdx = 0; knobIdx < novarwgt::kLastKnob; knobIdx++)
+			{
+				if (!evt.genieWeights.IsSet(knobIdx))
+					continue;
+				const auto & vals = evt.genieWeights[knobIdx];
+				genieWgts[4 * knobIdx]     = vals.minus2sigma;
+				genieWgts[4 * knobIdx + 1] = vals.minus1sigma;
+				genieWgts[4 * knobIdx + 2] = vals.plus1sigma;
+				genieWgts[4 * knobIdx + 3] = vals.plus2sigma;
+			}
+			tree->Fill();
+		}
+		tree->Write();
+
+		bool ok = true;
+
+		// read it back in batches that don't line up with the baskets, once with |q| as stored and once from Q2
+		novarwgt::TTreeBranchNames fromQ2;
+		fromQ2.q3 = "";
+		const std::vector<std::pair<std::string, novarwgt::TTreeBranchNames>> configs{{"q3 branch", {}}, {"q3 from Q2", fromQ2}};
+		for (const auto & config : configs)
+		{
+			novarwgt::TTreeBatchReader reader(tree, config.second);
+			reader.SetGeneratorInfo(novarwgt::kGENIE, {2, 12, 2});
+			if (reader.GetEntries() != Long64_t(evts.size()))
+			{
+				std::cerr << "TTreeBatchReader (" << config.first << "): " << reader.GetEntries() << " entries, but "
+				          << evts.size() << " were written" << std::endl;
+				ok = false;
+				continue;
+			}
+
+			const double q3Tol = config.second.q3.empty() ? 1e-9 : 1e-12;
+			novarwgt::EventBatch batch;
+			novarwgt::EventRecord rec;
+			std::vector<double> batchWgts;
+			const std::size_t batchSize = 7;
+			for (Long64_t first = 0; reader.ReadBatch(first, batchSize, batch) > 0; first += batchSize)
+			{
+				novarwgt::kCVTune2018.EventWeights(batch, batchWgts);
+				for (std::size_t idx = 0; idx < batch.size(); idx++)
+				{
+					const auto & expected = evts[first + idx];
+					const std::string name = "entry " + std::to_string(first + Long64_t(idx)) + " (" + config.first + ")";
+					batch.FillRecord(idx, rec);
+					ok = CheckReadRecord(rec, expected, q3Tol, name) && ok;
+
+					const double expectedWgt = novarwgt::kCVTune2018.EventWeight(expected);
+					if (!(std::abs(batchWgts[idx] - expectedWgt) <= 1e-9 * std::max(1., std::abs(expectedWgt))))
+					{
+						std::cerr << "TTreeBatchReader: " << name << " has weight " << batchWgts[idx]
+						          << " from Tune::EventWeights(), but its record has " << expectedWgt << std::endl;
+						ok = false;
+					}
+				}
+			}
+		}
+
+		// a Q2 that can't go with the q0 (here, with the sign flipped) must not quietly become |q| = NaN
+		auto badTree = new TTree("badQ2", "badQ2");   // owned by the file
+		badTree->Branch("Enu", &Enu, "Enu/D");
+		badTree->Branch("Q2", &Q2, "Q2/D");
+		badTree->Branch("q0", &q0, "q0/D");
+		badTree->Branch("mode", &mode, "mode/I");
+		badTree->Branch("ccnc", &ccnc, "ccnc/I");
+		badTree->Branch("pdg", &pdg, "pdg/I");
+		Enu = 2;
+		q0 = 0.5;
+		mode = novarwgt::kScQuasiElastic;
+		ccnc = 0;
+		pdg = 14;
+		for (const double badQ2 : {0.3, -0.3})
+		{
+			Q2 = badQ2;
+			badTree->Fill();
+		}
+		bool threw = false;
+		try
+		{
+			novarwgt::TTreeBatchReader reader(badTree, fromQ2);
+			novarwgt::EventBatch batch;
+			reader.ReadBatch(0, 2, batch);
+		}
+		catch (std::runtime_error &)
+		{
+			threw = true;
+		}
+		if (!threw)
+		{
+			std::cerr << "TTreeBatchReader: reading Q2 < -q0^2 didn't throw" << std::endl;
+			ok = false;
+		}
+
+		return ok;
+	}
+}
 
 int main()
 {
@@ -28,5 +1214,17 @@ int main()
 	if (ok)
 		std::cout << "All " << testEvents.size() << " events produced the expected behavior." << std::endl;
 
+	ok = TestWeightedSample() && ok;
+	ok = TestStaticTunes() && ok;
+	ok = TestDISnPionFamily() && ok;
+	ok = TestClassification() && ok;
+	ok = TestModifiedRecord() && ok;
+	ok = TestStoredWgtInterpolation() && ok;
+	ok = TestDerivatives() && ok;
+	ok = TestStoredWgtSplines() && ok;
+	ok = TestUniverseThrower() && ok;
+	ok = TestSpectrumAccumulator() && ok;
+	ok = TestTTreeReader() && ok;
+
 	return ok ? 0 : 1;
-}
\ No newline at end of file
+}
@@ -0,0 +1,141 @@
+/*
+ * WorkerPool.cxx:
+ *  Persistent worker threads for the library's parallel loops.
+ *
+ *  Created on: Oct. 19, 2026
+ *      Author: agent <agent@local>
+ */
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+#include "NOvARwgt/util/WorkerPool.h"
+
+namespace novarwgt
+{
+	namespace
+	{
+		/// The pool the current thread is a worker of (if any)
+		thread_local const WorkerPool * tOwningPool = nullptr;
+	}
+
+	// --------------------------------------
+	WorkerPool::WorkerPool(unsigned int nThreads)
+	{
+		if (nThreads == 0)
+			nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		fWorkers.reserve(nThreads);
+		for (unsigned int threadIdx = 0; threadIdx < nThreads; threadIdx++)
+			fWorkers.emplace_back(&WorkerPool::WorkerLoop, this);
+	}
+
+	// --------------------------------------
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(fMutex);
+			fStopping = true;
+		}
+		fWakeWorkers.notify_all();
+		for (auto & worker : fWorkers)
+			worker.join();
+	}
+
+	// --------------------------------------
+	void WorkerPool::Run(std::size_t nTasks, const std::function<void(std::size_t)> & task)
+	{
+		if (nTasks == 0)
+			return;
+
+		// handing the work to ourselves would never finish
+		if (tOwningPool == this)
+		{
+			for (std::size_t idx = 0; idx < nTasks; idx++)
+				task(idx);
+			return;
+		}
+
+		std::lock_guard<std::mutex> runLock(fRunMutex);
+		std::unique_lock<std::mutex> lock(fMutex);
+		fTask = &task;
+		fNTasks = nTasks;
+		fNextTask = 0;
+		fNFinished = 0;
+		fErrorIdx = std::numeric_limits<std::size_t>::max();
+		fError = nullptr;
+		fJobSerial++;
+		fWakeWorkers.notify_all();
+
+		fJobDone.wait(lock, [this]() { return fNFinished == fNTasks; });
+		fTask = nullptr;
+		std::exception_ptr error = fError;
+		fError = nullptr;
+		lock.unlock();
+
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	// --------------------------------------
+	WorkerPool & WorkerPool::Shared(unsigned int nThreads)
+	{
+		if (nThreads == 0)
+			nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		// the pools are deliberately never destroyed:
+		// their workers own thread-local GENIE objects, which mustn't be torn down
+		// during static destruction after GENIE's own singletons may already be gone
+		static std::mutex poolsMutex;
+		static auto * pools = new std::unordered_map<unsigned int, WorkerPool*>;
+
+		std::lock_guard<std::mutex> lock(poolsMutex);
+		WorkerPool * & pool = (*pools)[nThreads];
+		if (!pool)
+			pool = new WorkerPool(nThreads);
+		return *pool;
+	}
+
+	// --------------------------------------
+	void WorkerPool::WorkerLoop()
+	{
+		tOwningPool = this;
+
+		std::size_t lastJob = 0;
+		std::unique_lock<std::mutex> lock(fMutex);
+		while (true)
+		{
+			fWakeWorkers.wait(lock, [this, lastJob]() { return fStopping || fJobSerial != lastJob; });
+			if (fStopping)
+				return;
+			lastJob = fJobSerial;
+
+			while (fNextTask < fNTasks)
+			{
+				const std::size_t idx = fNextTask++;
+				const auto & task = *fTask;
+				lock.unlock();
+
+				std::exception_ptr error;
+				try
+				{
+					task(idx);
+				}
+				catch (...)
+				{
+					error = std::current_exception();
+				}
+
+				lock.lock();
+				if (error && idx < fErrorIdx)
+				{
+					fErrorIdx = idx;
+					fError = error;
+				}
+				if (++fNFinished == fNTasks)
+					fJobDone.notify_all();
+			}
+		}
+	}
+}